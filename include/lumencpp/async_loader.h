@@ -0,0 +1,75 @@
+#ifndef LUMENCPP_ASYNC_LOADER_H
+#define LUMENCPP_ASYNC_LOADER_H
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "document.h"
+#include "options.h"
+
+namespace lumen {
+
+// Loads many files at once, parsing each one as soon as it has been read. A
+// reader keeps up to queue_depth reads in flight, through io_uring where the
+// kernel provides it and through blocking reader threads otherwise, while
+// parser threads work on the files that have arrived.
+class AsyncLoader {
+public:
+    struct Options {
+        // Files being read or waiting for a parser at once.
+        std::size_t queue_depth = 64;
+
+        // Zero starts one parser thread per hardware thread.
+        std::size_t parse_threads = 0;
+
+        // Disable to always read with blocking threads.
+        bool use_io_uring = true;
+
+        // Shared by all parser threads, so a profile sink or a string pool
+        // must tolerate concurrent use. Setting diagnostics only enables
+        // error recovery; each result collects its own.
+        ParseOptions parse_options;
+    };
+
+    struct Result {
+        // Position of the file in the list passed to load().
+        std::size_t index = 0;
+        std::filesystem::path path;
+
+        Document document;
+
+        // Set instead of the document when reading or parsing failed.
+        std::exception_ptr error;
+
+        // The errors recovered from, when the parse options ask for that.
+        std::vector<ParseError> diagnostics;
+    };
+
+    using Callback = std::function<void(Result)>;
+
+    [[nodiscard]] AsyncLoader() : AsyncLoader{Options{}} {}
+
+    [[nodiscard]] explicit AsyncLoader(Options options) noexcept
+    : m_options{options} {}
+
+    // Calls the callback on the calling thread for every file, one at a time
+    // and in the order the files finish. If the callback throws, the files
+    // still pending are abandoned and the exception is rethrown.
+    void load(
+        std::span<const std::filesystem::path> paths,
+        const Callback& callback) const;
+
+    // Whether the kernel lets load() read through io_uring.
+    [[nodiscard]] static bool io_uring_available();
+
+private:
+    Options m_options;
+};
+
+} // namespace lumen
+
+#endif
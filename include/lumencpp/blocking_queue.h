@@ -0,0 +1,94 @@
+#ifndef LUMENCPP_BLOCKING_QUEUE_H
+#define LUMENCPP_BLOCKING_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace lumen::details {
+
+// A queue between threads. Producers wait while it is full and consumers wait
+// while it is empty, until the queue is closed.
+template <typename Element> class BlockingQueue {
+public:
+    [[nodiscard]] explicit BlockingQueue(
+        std::size_t capacity = std::numeric_limits<std::size_t>::max()) noexcept
+    : m_capacity{capacity} {}
+
+    // Returns false and drops the element if the queue is closed.
+    bool push(Element element) {
+        std::unique_lock lock{m_mutex};
+        m_not_full.wait(lock, [this] {
+            return m_closed || m_elements.size() < m_capacity;
+        });
+
+        if (m_closed) {
+            return false;
+        }
+
+        m_elements.push_back(std::move(element));
+        m_not_empty.notify_one();
+
+        return true;
+    }
+
+    // Returns false and leaves the element alone if the queue is full or
+    // closed, instead of waiting.
+    bool try_push(Element& element) {
+        std::lock_guard lock{m_mutex};
+
+        if (m_closed || m_elements.size() >= m_capacity) {
+            return false;
+        }
+
+        m_elements.push_back(std::move(element));
+        m_not_empty.notify_one();
+
+        return true;
+    }
+
+    // Returns nothing once the queue is closed and drained.
+    [[nodiscard]] std::optional<Element> pop() {
+        std::unique_lock lock{m_mutex};
+        m_not_empty.wait(
+            lock, [this] { return m_closed || !m_elements.empty(); });
+
+        if (m_elements.empty()) {
+            return std::nullopt;
+        }
+
+        auto result = std::move(m_elements.front());
+        m_elements.pop_front();
+        m_not_full.notify_one();
+
+        return result;
+    }
+
+    // Wakes every waiting thread; elements already queued can still be popped.
+    void close() {
+        {
+            std::lock_guard lock{m_mutex};
+            m_closed = true;
+        }
+
+        m_not_full.notify_all();
+        m_not_empty.notify_all();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_not_full;
+    std::condition_variable m_not_empty;
+
+    std::deque<Element> m_elements;
+    std::size_t m_capacity;
+    bool m_closed = false;
+};
+
+} // namespace lumen::details
+
+#endif
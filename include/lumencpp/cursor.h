@@ -0,0 +1,221 @@
+#ifndef LUMENCPP_CURSOR_H
+#define LUMENCPP_CURSOR_H
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "document.h"
+#include "value.h"
+
+namespace lumen {
+
+namespace details {
+
+// How a value was reached from its parent: by key, or by index when there is
+// no key.
+struct PathSegment {
+    const std::string* key = nullptr;
+    std::size_t index = 0;
+};
+
+} // namespace details
+
+// Walks a tree depth-first without recursion, on a stack of one entry per
+// level. Members of an object come in the order of the object. Elements of
+// packed arrays are read one at a time into a value held by the cursor, so
+// the arrays are not unpacked.
+//
+//     for (DepthFirstCursor cursor{document}; !cursor.done();) {
+//         if (is_secret(cursor.key())) {
+//             cursor.skip();
+//         } else {
+//             export_value(cursor.path(), cursor.value());
+//             cursor.next();
+//         }
+//     }
+class DepthFirstCursor {
+public:
+    // Visits the root first, with an empty path.
+    [[nodiscard]] explicit DepthFirstCursor(const Value& root);
+
+    // Visits the members, but not the object itself.
+    [[nodiscard]] explicit DepthFirstCursor(const Object& root);
+
+    [[nodiscard]] explicit DepthFirstCursor(const Document& document)
+    : DepthFirstCursor{document.data} {}
+
+    // Visit a member or an element and its children as though the walk had
+    // started from the enclosing object or array.
+    [[nodiscard]] explicit DepthFirstCursor(const Object::value_type& member);
+
+    [[nodiscard]] DepthFirstCursor(const Value& element, std::size_t index);
+
+    [[nodiscard]] bool done() const noexcept {
+        return m_value == nullptr && m_frames.empty();
+    }
+
+    // Valid until the cursor moves if the value is an element of a packed
+    // array.
+    [[nodiscard]] const Value& value() const noexcept {
+        return m_value != nullptr ? *m_value : m_element;
+    }
+
+    // Empty for elements of arrays and for the root.
+    [[nodiscard]] std::string_view key() const noexcept;
+
+    // Position within the enclosing array; zero for other values.
+    [[nodiscard]] std::size_t index() const noexcept;
+
+    [[nodiscard]] bool is_element() const noexcept;
+
+    // Number of keys and indices in the path.
+    [[nodiscard]] std::size_t depth() const noexcept;
+
+    // Keys joined by dots, with array elements as [index]; valid until the
+    // cursor moves. Rendered on request and only from the first level that
+    // changed since the last request, so a walk that does not ask for paths
+    // does not build them and one that does builds each segment once.
+    [[nodiscard]] std::string_view path() const;
+
+    // Moves to the first child of the current value, or past it if it has
+    // none.
+    void next();
+
+    // Moves past the current value and its children.
+    void skip();
+
+private:
+    struct Frame {
+        // Null for an array.
+        const Object* object = nullptr;
+        Object::const_iterator member;
+
+        const Value* begin = nullptr;
+        const Value* element = nullptr;
+        const Value* end = nullptr;
+
+        // Set instead of the above for a packed array.
+        const PackedArray* packed = nullptr;
+        std::size_t index = 0;
+    };
+
+    // Where the path ended after the segment of a frame, and the member or
+    // element the frame was at.
+    struct RenderedSegment {
+        const void* position = nullptr;
+        std::size_t end = 0;
+    };
+
+    [[nodiscard]] static details::PathSegment
+    segment(const Frame& frame) noexcept;
+
+    [[nodiscard]] static const void* position(const Frame& frame) noexcept;
+
+    [[nodiscard]] std::optional<details::PathSegment>
+    segment() const noexcept;
+
+    // Pushes a frame for the children of the current value, if it has any.
+    bool descend();
+
+    // Null while at an element of a packed array, which is read into
+    // m_element.
+    const Value* m_value = nullptr;
+    Value m_element;
+
+    std::optional<details::PathSegment> m_root;
+    std::vector<Frame> m_frames;
+
+    // Only the segments of frames that moved since the last path() are
+    // rendered again.
+    mutable std::string m_path;
+    mutable std::vector<RenderedSegment> m_rendered;
+    std::size_t m_root_path_size = 0;
+};
+
+// Walks a tree level by level. Rendering paths on demand needs the chain of
+// parents, so it keeps an entry for every value reached so far; prefer
+// DepthFirstCursor where the order does not matter.
+class BreadthFirstCursor {
+public:
+    [[nodiscard]] explicit BreadthFirstCursor(const Value& root);
+    [[nodiscard]] explicit BreadthFirstCursor(const Object& root);
+
+    [[nodiscard]] explicit BreadthFirstCursor(const Document& document)
+    : BreadthFirstCursor{document.data} {}
+
+    [[nodiscard]] bool done() const noexcept {
+        return m_position == m_entries.size();
+    }
+
+    // Valid until the cursor moves if the value is an element of a packed
+    // array.
+    [[nodiscard]] const Value& value() const noexcept;
+
+    [[nodiscard]] std::string_view key() const noexcept;
+    [[nodiscard]] std::size_t index() const noexcept;
+    [[nodiscard]] bool is_element() const noexcept;
+    [[nodiscard]] std::size_t depth() const noexcept;
+
+    // Valid until the cursor moves.
+    [[nodiscard]] std::string_view path() const;
+
+    // Queues the children of the current value and moves to the next one.
+    void next();
+
+    // Moves to the next value without queueing the children of this one.
+    void skip() noexcept { ++m_position; }
+
+private:
+    static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+    struct Entry {
+        // Null for an element of a packed array, which is read from `packed`
+        // at the index of the segment.
+        const Value* value = nullptr;
+        const PackedArray* packed = nullptr;
+        std::optional<details::PathSegment> segment;
+
+        std::size_t parent = none;
+        std::size_t depth = 0;
+    };
+
+    std::vector<Entry> m_entries;
+    std::size_t m_position = 0;
+
+    // Entries from the current one up to the outermost, reused by path().
+    mutable std::vector<std::size_t> m_chain;
+    mutable std::string m_path;
+
+    mutable Value m_element;
+};
+
+// Returns false to leave out the children of the value.
+using TraversalVisitor = std::function<bool(const DepthFirstCursor&)>;
+
+// Walks every top-level member depth-first, spreading them over up to
+// `threads` threads, the calling one included; zero uses one per hardware
+// thread. The visitor is called concurrently. If it throws, the walk stops
+// and the first exception is rethrown.
+void traverse_parallel(
+    const Object& root, const TraversalVisitor& visitor,
+    std::size_t threads = 0);
+
+inline void traverse_parallel(
+    const Document& document, const TraversalVisitor& visitor,
+    std::size_t threads = 0) {
+    traverse_parallel(document.data, visitor, threads);
+}
+
+// Visits the root on the calling thread, then spreads its members or
+// elements over the threads.
+void traverse_parallel(
+    const Value& root, const TraversalVisitor& visitor,
+    std::size_t threads = 0);
+
+} // namespace lumen
+
+#endif
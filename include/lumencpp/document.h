@@ -4,12 +4,19 @@
 #include <filesystem>
 #include <fstream>
 #include <initializer_list>
+#include <istream>
 #include <sstream>
 #include <string_view>
 #include <utility>
+#include <vector>
 
+#include "exceptions.h"
+#include "frozen_document.h"
 #include "lexer.h"
+#include "line_index.h"
+#include "options.h"
 #include "parser.h"
+#include "reader.h"
 #include "value.h"
 
 namespace lumen {
@@ -46,27 +53,96 @@ struct Document {
         return data[key];
     }
 
+    [[nodiscard]] FrozenDocument freeze() const { return FrozenDocument{data}; }
+
     Object data;
 };
 
+namespace details {
+
+// Lexes into `tokens` so that ParseSession can keep their storage.
+[[nodiscard]] inline Document parse(
+    Lexer& lexer, Parser& parser, std::vector<Token>& tokens,
+    std::string_view source, std::string_view filename, Object predefined,
+    const ParseOptions& options) {
+    auto* diagnostics = options.diagnostics;
+    auto reported = diagnostics != nullptr ? diagnostics->size() : 0;
+
+    try {
+        lexer.lex(source, filename, tokens);
+
+        Document result =
+            parser.parse(tokens, filename, std::move(predefined));
+
+        if (diagnostics != nullptr && !options.track_positions) {
+            LineIndex index{source};
+
+            for (auto i = reported; i < diagnostics->size(); ++i) {
+                auto& error = (*diagnostics)[i];
+                error.source = index.resolve(error.source);
+            }
+        }
+
+        return result;
+    } catch (ParseError& error) {
+        if (!options.track_positions) {
+            error.source = LineIndex{source}.resolve(error.source);
+        }
+
+        throw;
+    }
+}
+
+} // namespace details
+
 [[nodiscard]] inline Document parse(
     std::string_view source, const std::string& filename = "<string>",
-    Object predefined = {}) {
-    return Parser{}.parse(
-        Lexer{}.lex(source, filename), filename, std::move(predefined));
+    Object predefined = {}, const ParseOptions& options = {}) {
+    Lexer lexer{options};
+    Parser parser{options};
+    std::vector<Token> tokens;
+
+    return details::parse(
+        lexer, parser, tokens, source, filename, std::move(predefined),
+        options);
 }
 
-[[nodiscard]] inline Document
-parse(std::string_view source, Object predefined, const std::string& filename) {
-    return parse(source, filename, std::move(predefined));
+[[nodiscard]] inline Document parse(
+    std::string_view source, Object predefined, const std::string& filename,
+    const ParseOptions& options = {}) {
+    return parse(source, filename, std::move(predefined), options);
 }
 
-[[nodiscard]] inline auto
-parse_file(const std::filesystem::path& path, Object predefined = {}) {
-    std::ostringstream buffer;
-    buffer << std::ifstream{path}.rdbuf();
+[[nodiscard]] inline Document parse(
+    ChunkReader reader, const std::string& filename = "<stream>",
+    Object predefined = {}, const ParseOptions& options = {}) {
+    Lexer lexer{options};
+    return Parser{options}.parse(
+        lexer, reader, filename, std::move(predefined));
+}
+
+[[nodiscard]] inline Document parse(
+    std::istream& stream, const std::string& filename = "<stream>",
+    Object predefined = {}, const ParseOptions& options = {}) {
+    return parse(
+        ChunkReader::from_stream(stream), filename, std::move(predefined),
+        options);
+}
+
+[[nodiscard]] inline auto parse_file(
+    const std::filesystem::path& path, Object predefined = {},
+    const ParseOptions& options = {}) {
+    std::ifstream file{path, std::ios::binary};
+
+    // Resolving offset-only positions needs the whole source at hand.
+    if (!options.track_positions) {
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+
+        return parse(buffer.str(), path, std::move(predefined), options);
+    }
 
-    return parse(buffer.str(), path, std::move(predefined));
+    return parse(file, path, std::move(predefined), options);
 }
 
 } // namespace lumen
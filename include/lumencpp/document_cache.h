@@ -0,0 +1,106 @@
+#ifndef LUMENCPP_DOCUMENT_CACHE_H
+#define LUMENCPP_DOCUMENT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "document.h"
+#include "document_reaper.h"
+#include "options.h"
+
+namespace lumen {
+
+// Shares parsed documents between independent callers of parse_file. An entry
+// is reused for as long as the file keeps its inode, modification time and
+// size (and, optionally, its content); concurrent requests for one file are
+// served by a single parse. All members are thread-safe.
+class DocumentCache {
+public:
+    struct Options {
+        // Least recently used documents are dropped to stay within the budget;
+        // a document still held by a caller stays alive.
+        std::size_t memory_budget = 64 * 1024 * 1024;
+
+        // Also compare a hash of the content on every lookup; this reads the
+        // file but still skips parsing it.
+        bool verify_content = false;
+
+        // When set, documents that are replaced, evicted or cleared are
+        // destroyed there instead of under the cache's lock.
+        DocumentReaper* reaper = nullptr;
+
+        ParseOptions parse_options;
+    };
+
+    [[nodiscard]] DocumentCache() : DocumentCache{Options{}} {}
+
+    [[nodiscard]] explicit DocumentCache(Options options) noexcept
+    : m_options{options} {}
+
+    DocumentCache(const DocumentCache&) = delete;
+    DocumentCache& operator=(const DocumentCache&) = delete;
+
+    // The cache shared by the whole process.
+    [[nodiscard]] static DocumentCache& global();
+
+    [[nodiscard]] std::shared_ptr<const Document>
+    parse_file(const std::filesystem::path& path);
+
+    void clear();
+
+    // Estimated memory held by the cached documents.
+    [[nodiscard]] std::size_t memory_usage() const;
+
+private:
+    using Result = std::shared_ptr<const Document>;
+
+    struct FileState {
+        [[nodiscard]] bool operator==(const FileState&) const = default;
+
+        std::uint64_t device = 0;
+        std::uint64_t inode = 0;
+        std::int64_t modified = 0;
+        std::uint64_t size = 0;
+    };
+
+    struct Entry {
+        Result document;
+
+        FileState state;
+        std::optional<std::size_t> content_hash;
+
+        std::size_t memory_usage = 0;
+        std::list<std::string>::iterator recency;
+    };
+
+    [[nodiscard]] static FileState stat(const std::filesystem::path& path);
+
+    [[nodiscard]] Result
+    load(const std::filesystem::path& path, const std::string& key);
+
+    void insert(const std::string& key, Entry entry);
+    void erase(std::unordered_map<std::string, Entry>::iterator entry);
+    void evict();
+
+    Options m_options;
+
+    mutable std::mutex m_mutex;
+
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_recency;
+    std::size_t m_memory_usage = 0;
+
+    std::unordered_map<std::string, std::shared_future<Result>> m_loading;
+};
+
+} // namespace lumen
+
+#endif
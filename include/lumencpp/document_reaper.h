@@ -0,0 +1,76 @@
+#ifndef LUMENCPP_DOCUMENT_REAPER_H
+#define LUMENCPP_DOCUMENT_REAPER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <variant>
+
+#include "blocking_queue.h"
+#include "document.h"
+
+namespace lumen {
+
+// Destroys retired documents on a background thread of low priority, so that
+// dropping a large tree does not stall the thread that replaced it:
+//
+//     reaper.retire(std::exchange(config, std::move(reloaded)));
+//
+// At most capacity documents wait at once; when the queue is full, retire()
+// destroys the document on the calling thread instead of waiting. The
+// destructor destroys the documents still queued. All members are
+// thread-safe.
+class DocumentReaper {
+public:
+    struct Options {
+        std::size_t capacity = 64;
+
+        // Runs the thread at the lowest scheduling priority where the system
+        // allows it.
+        bool lower_priority = true;
+    };
+
+    [[nodiscard]] DocumentReaper() : DocumentReaper{Options{}} {}
+
+    [[nodiscard]] explicit DocumentReaper(Options options);
+
+    DocumentReaper(const DocumentReaper&) = delete;
+    DocumentReaper& operator=(const DocumentReaper&) = delete;
+
+    ~DocumentReaper();
+
+    // The reaper shared by the whole process.
+    [[nodiscard]] static DocumentReaper& global();
+
+    void retire(Document document);
+
+    // Drops the reference on the background thread, so that the document is
+    // destroyed there if it was the last one.
+    void retire(std::shared_ptr<const Document> document);
+
+    // Waits until every document retired so far has been destroyed.
+    void flush();
+
+    // Documents retired but not yet destroyed.
+    [[nodiscard]] std::size_t pending() const;
+
+private:
+    using Retired = std::variant<Document, std::shared_ptr<const Document>>;
+
+    void push(Retired retired);
+    void release() noexcept;
+
+    details::BlockingQueue<Retired> m_queue;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_idle;
+    std::size_t m_pending = 0;
+
+    std::jthread m_thread;
+};
+
+} // namespace lumen
+
+#endif
@@ -46,6 +46,47 @@ struct TypeMismatch : Exception {
     std::string description;
 };
 
+struct IOError : Exception {
+    [[nodiscard]] IOError(std::string description) noexcept
+    : description{std::move(description)} {}
+
+    [[nodiscard]] const char* what() const noexcept override {
+        static std::string formatted;
+        formatted = "I/O error: " + description;
+
+        return formatted.c_str();
+    }
+
+    std::string description;
+};
+
+struct UnknownKey : Exception {
+    [[nodiscard]] UnknownKey(std::string key) noexcept : key{std::move(key)} {}
+
+    [[nodiscard]] const char* what() const noexcept override {
+        static std::string formatted;
+        formatted = "unknown key: " + key;
+
+        return formatted.c_str();
+    }
+
+    std::string key;
+};
+
+struct SchemaError : Exception {
+    [[nodiscard]] SchemaError(std::string description) noexcept
+    : description{std::move(description)} {}
+
+    [[nodiscard]] const char* what() const noexcept override {
+        static std::string formatted;
+        formatted = "invalid schema: " + description;
+
+        return formatted.c_str();
+    }
+
+    std::string description;
+};
+
 } // namespace lumen
 
 #endif
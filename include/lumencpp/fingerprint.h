@@ -0,0 +1,72 @@
+#ifndef LUMENCPP_FINGERPRINT_H
+#define LUMENCPP_FINGERPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "document.h"
+#include "value.h"
+
+namespace lumen {
+
+// A 64-bit hash of the content of a value that ignores how the value was
+// written: formatting, comments, the order of object members and whether an
+// array is packed do not affect it. It is stable across runs and platforms.
+//
+// Every value is reduced to a 64-bit word by `mix` (the MurmurHash3
+// finalizer) and combined with a tag for its kind:
+//
+//     integer       combine(Integer, bits) if non-negative, whether it is
+//                   stored as UInt or Int; combine(NegativeInteger, bits)
+//                   otherwise
+//     float         combine(Float, bits), with -0.0 as 0.0 and a single NaN
+//     bool          combine(Bool, 0 or 1)
+//     string        combine(String, hash of the bytes in little-endian words)
+//     array         h = combine(Array, size); h = mix(h + element) for every
+//                   element in order
+//     object        combine(Object, mix(sum) ^ size), where sum adds
+//                   mix(hash(key) ^ rotl(value, 32)) over the members modulo
+//                   2^64
+//     undefined     combine(Undefined, 0)
+//
+// where combine(tag, word) = mix(word ^ mix(tag)). A document is
+// fingerprinted as an object.
+//
+// Because an object's fingerprint is a sum of independent member terms,
+// ObjectFingerprint can update it for a changed member in constant time from
+// the cached fingerprints of the old and new values.
+[[nodiscard]] std::uint64_t fingerprint(const Value& value);
+[[nodiscard]] std::uint64_t fingerprint(const Array& array);
+[[nodiscard]] std::uint64_t fingerprint(const Object& object);
+
+[[nodiscard]] inline std::uint64_t fingerprint(const Document& document) {
+    return fingerprint(document.data);
+}
+
+class ObjectFingerprint {
+public:
+    [[nodiscard]] ObjectFingerprint() = default;
+
+    [[nodiscard]] explicit ObjectFingerprint(const Object& object);
+
+    void add(std::string_view key, std::uint64_t value) noexcept;
+    void remove(std::string_view key, std::uint64_t value) noexcept;
+
+    void replace(
+        std::string_view key, std::uint64_t old_value,
+        std::uint64_t new_value) noexcept {
+        remove(key, old_value);
+        add(key, new_value);
+    }
+
+    [[nodiscard]] std::uint64_t value() const noexcept;
+
+private:
+    std::uint64_t m_sum = 0;
+    std::size_t m_size = 0;
+};
+
+} // namespace lumen
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef LUMENCPP_FIXED_STRING_H
+#define LUMENCPP_FIXED_STRING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+namespace lumen::details {
+
+// A string literal usable as a template argument.
+template <std::size_t Size> struct FixedString {
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    consteval FixedString(const char (&string)[Size]) {
+        std::copy_n(string, Size, data);
+    }
+
+    [[nodiscard]] constexpr std::string_view view() const noexcept {
+        return {data, Size - 1};
+    }
+
+    char data[Size]{};
+};
+
+} // namespace lumen::details
+
+#endif
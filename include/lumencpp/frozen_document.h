@@ -0,0 +1,69 @@
+#ifndef LUMENCPP_FROZEN_DOCUMENT_H
+#define LUMENCPP_FROZEN_DOCUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "value.h"
+#include "value_view.h"
+
+namespace lumen {
+
+// An immutable copy of a document: every node lives in one contiguous table,
+// object members are sorted by key and strings share a single pool. Nothing
+// is ever written after construction, so any number of threads may read it
+// concurrently.
+class FrozenDocument {
+public:
+    [[nodiscard]] FrozenDocument() : m_nodes(1) {
+        m_nodes.front().type = Value::Type::Object;
+    }
+
+    [[nodiscard]] explicit FrozenDocument(const Object& data);
+
+    [[nodiscard]] ValueView root() const noexcept {
+        return {m_nodes, m_strings};
+    }
+
+    [[nodiscard]] auto begin() const noexcept { return root().begin(); }
+    [[nodiscard]] auto end() const noexcept { return root().end(); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return root().size(); }
+
+    [[nodiscard]] bool contains(std::string_view key) const {
+        return root().contains(key);
+    }
+
+    [[nodiscard]] ValueView at(std::string_view key) const {
+        return root()[key];
+    }
+
+    [[nodiscard]] ValueView operator[](std::string_view key) const {
+        return root()[key];
+    }
+
+    [[nodiscard]] std::span<const details::FlatNode> nodes() const noexcept {
+        return m_nodes;
+    }
+
+    [[nodiscard]] std::string_view strings() const noexcept {
+        return m_strings;
+    }
+
+private:
+    [[nodiscard]] std::uint32_t add_string(std::string_view string);
+
+    void write(const Value& value, std::size_t index);
+    void write(const Object& object, std::size_t index);
+
+    std::vector<details::FlatNode> m_nodes;
+    std::string m_strings;
+};
+
+} // namespace lumen
+
+#endif
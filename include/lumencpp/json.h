@@ -0,0 +1,57 @@
+#ifndef LUMENCPP_JSON_H
+#define LUMENCPP_JSON_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "document.h"
+#include "options.h"
+#include "value.h"
+
+namespace lumen {
+
+// Reads RFC 8259 JSON straight into values. Integers are classified like in
+// lumen documents: negative ones become Int, others UInt, and ones with a
+// fraction or an exponent Float. `null` becomes an undefined value. Of the
+// options, only max_depth applies.
+[[nodiscard]] Value parse_json_value(
+    std::string_view source, const std::string& filename = "<string>",
+    const ParseOptions& options = {});
+
+// The top-level value must be an object.
+[[nodiscard]] Document parse_json(
+    std::string_view source, const std::string& filename = "<string>",
+    const ParseOptions& options = {});
+
+// Writes compact JSON, or JSON indented by `indent` spaces when it is not
+// zero. Undefined values and non-finite floats are written as `null`.
+void write_json(
+    const Value& value, std::string& output, std::size_t indent = 0);
+void write_json(
+    const Object& object, std::string& output, std::size_t indent = 0);
+
+[[nodiscard]] inline std::string
+to_json(const Value& value, std::size_t indent = 0) {
+    std::string result;
+    write_json(value, result, indent);
+
+    return result;
+}
+
+[[nodiscard]] inline std::string
+to_json(const Object& object, std::size_t indent = 0) {
+    std::string result;
+    write_json(object, result, indent);
+
+    return result;
+}
+
+[[nodiscard]] inline std::string
+to_json(const Document& document, std::size_t indent = 0) {
+    return to_json(document.data, indent);
+}
+
+} // namespace lumen
+
+#endif
@@ -1,50 +1,143 @@
 #ifndef LUMENCPP_LEXER_H
 #define LUMENCPP_LEXER_H
 
+#include <bit>
 #include <cctype>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "exceptions.h"
+#include "options.h"
+#include "profiler.h"
+#include "reader.h"
+#include "swar.h"
 #include "token.h"
+#include "utf8.h"
 
 namespace lumen {
 
 class Lexer {
 public:
+    [[nodiscard]] Lexer() = default;
+
+    [[nodiscard]] constexpr explicit Lexer(ParseOptions options) noexcept
+    : m_options{options} {}
+
+    [[nodiscard]] constexpr std::vector<Token>
+    lex(std::string_view source, std::string_view filename);
+
+    // Streamed input always tracks positions, since the source is gone by the
+    // time an error could be resolved.
     [[nodiscard]] std::vector<Token>
-    lex(std::string_view source, std::string filename);
+    lex(ChunkReader& reader, std::string_view filename);
+
+    // Replaces the contents of `tokens`, keeping its capacity.
+    constexpr void lex(
+        std::string_view source, std::string_view filename,
+        std::vector<Token>& tokens);
+
+    // Lexes streamed input a batch at a time, for a parser that consumes the
+    // tokens as they come: start() and then next() until a batch ends with
+    // the end of file.
+    void start(ChunkReader& reader, std::string_view filename);
+
+    // Appends up to `count` tokens to `tokens`, the end of file last.
+    constexpr void next(std::vector<Token>& tokens, std::size_t count);
 
 private:
-    [[nodiscard]] char at() const noexcept { return *m_at; }
-    [[nodiscard]] bool at_end() const noexcept { return m_at == m_end; }
+    constexpr void start();
 
-    char eat() noexcept {
-        if (at() == '\n') {
-            ++m_position.line;
-            m_position.column = 1;
-        } else {
-            ++m_position.column;
+    // Throws, unless the options ask to recover from errors; then lexing goes
+    // on and the current token is marked invalid. During constant evaluation
+    // the throw makes a malformed document a compile error.
+    constexpr void fail(std::string description, SourceRegion source) {
+        if (m_options.diagnostics == nullptr) {
+            throw ParseError{std::move(description), m_filename, source};
+        }
+
+        m_options.diagnostics->emplace_back(
+            std::move(description), m_filename, source);
+        ++m_error_count;
+    }
+
+    // Unlike the functions of <cctype>, these do not depend on the locale
+    // and can be evaluated at compile time.
+    [[nodiscard]] static constexpr bool is_space(char character) noexcept {
+        return character == ' ' || (character >= '\t' && character <= '\r');
+    }
+
+    [[nodiscard]] static constexpr bool is_alpha(char character) noexcept {
+        return (character >= 'a' && character <= 'z') ||
+               (character >= 'A' && character <= 'Z');
+    }
+
+    [[nodiscard]] static constexpr bool
+    is_alphanumeric(char character) noexcept {
+        return is_alpha(character) || details::swar::is_digit<10>(character);
+    }
+
+    [[nodiscard]] constexpr char at() const noexcept { return *m_at; }
+    [[nodiscard]] constexpr bool at_end() { return m_at == m_end && !refill(); }
+
+    constexpr bool refill() {
+        if (m_reader == nullptr) {
+            return false;
+        }
+
+        m_base_offset += static_cast<std::uint32_t>(m_end - m_begin);
+
+        auto chunk = m_reader->next();
+
+        m_begin = chunk.data();
+        m_at = m_begin;
+        m_end = m_begin + chunk.size();
+
+        return !chunk.empty();
+    }
+
+    constexpr char eat() noexcept {
+        if (m_track_positions) {
+            if (at() == '\n') {
+                ++m_position.line;
+                m_position.column = 1;
+            } else {
+                ++m_position.column;
+            }
         }
 
         return *(m_at++);
     }
 
-    void skip_whitespaces() noexcept {
-        while (!at_end() && std::isspace(at()) && at() != '\n') {
+    [[nodiscard]] constexpr Position
+    position(std::int32_t shift = 0) const noexcept {
+        auto offset =
+            m_base_offset + static_cast<std::uint32_t>(m_at - m_begin + shift);
+
+        if (!m_track_positions) {
+            return {0, 0, offset};
+        }
+
+        return {m_position.line, m_position.column + shift, offset};
+    }
+
+    constexpr void skip_whitespaces() {
+        while (!at_end() && is_space(at()) && at() != '\n') {
             eat();
             m_can_parse_long_token = true;
         }
     }
 
-    void skip_comment() noexcept {
+    constexpr void skip_comment() {
         while (!at_end() && at() != '\n') {
             eat();
         }
     }
 
-    void skip_useless() noexcept {
+    constexpr void skip_useless() {
         skip_whitespaces();
 
         while (!at_end() && at() == '#') {
@@ -53,48 +146,541 @@ private:
         }
     }
 
-    [[nodiscard]] std::string get_integer(auto is_digit) {
+    // Moves over bytes that are known not to contain line breaks.
+    constexpr void advance(std::size_t count) noexcept {
+        m_at += count;
+
+        if (m_track_positions) {
+            m_position.column += static_cast<std::uint32_t>(count);
+        }
+    }
+
+    // Counts the digits ahead in the current chunk, eight bytes at a time
+    // where enough of them are available.
+    template <unsigned Base>
+    [[nodiscard]] constexpr std::size_t count_digits() const noexcept {
+        const auto* at = m_at;
+
+        if constexpr (details::swar::enabled) {
+            while (m_end - at >= 8) {
+                auto digits = details::swar::count_digits<Base>(at);
+                at += digits;
+
+                if (digits < 8) {
+                    return static_cast<std::size_t>(at - m_at);
+                }
+            }
+        }
+
+        while (at != m_end && details::swar::is_digit<Base>(*at)) {
+            ++at;
+        }
+
+        return static_cast<std::size_t>(at - m_at);
+    }
+
+    // Counts the string characters ahead in the current chunk that need no
+    // unescaping, UTF-8 validation or line tracking.
+    [[nodiscard]] constexpr std::size_t
+    count_plain_characters(char quote) const noexcept {
+        namespace swar = details::swar;
+
+        const auto* at = m_at;
+
+        if constexpr (swar::enabled) {
+            auto quote_byte = static_cast<std::uint8_t>(quote);
+
+            while (m_end - at >= 8) {
+                auto chunk = swar::load(at);
+                auto special = swar::equal(chunk, quote_byte) |
+                               swar::equal(chunk, '\\') |
+                               swar::equal(chunk, '\n') |
+                               (chunk & swar::high_bits);
+
+                if (special != 0) {
+                    at += std::countr_zero(special) / 8;
+                    return static_cast<std::size_t>(at - m_at);
+                }
+
+                at += 8;
+            }
+        }
+
+        while (at != m_end && *at != quote && *at != '\\' && *at != '\n' &&
+               static_cast<unsigned char>(*at) < 0x80) {
+            ++at;
+        }
+
+        return static_cast<std::size_t>(at - m_at);
+    }
+
+    template <unsigned Base = 10>
+    [[nodiscard]] constexpr std::string get_integer() {
         std::string result;
 
-        while (!at_end() && (is_digit(at()) || at() == '_')) {
-            if (at() == '_') {
+        while (!at_end()) {
+            auto digits = count_digits<Base>();
+
+            if (digits == 0) {
+                if (at() != '_') {
+                    break;
+                }
+
                 eat();
                 continue;
             }
 
-            result += eat();
+            result.append(m_at, digits);
+            advance(digits);
         }
 
         if (result.empty()) {
-            Position end_position{m_position.line, m_position.column + 1};
-
-            throw ParseError{
-                "expected a digit", m_filename, {m_position, end_position}};
+            fail("expected a digit", {position(), position(1)});
         }
 
         return result;
     }
 
-    [[nodiscard]] std::string get_integer() {
-        return get_integer(
-            [](char character) { return std::isdigit(character); });
-    }
+    [[nodiscard]] constexpr Token get_identifier();
+    [[nodiscard]] constexpr Token get_number();
+    [[nodiscard]] constexpr Token get_string();
+    constexpr void get_escape(std::string& result);
+    constexpr void get_utf8_sequence(std::string& result);
+
+    [[nodiscard]] constexpr Token get_token();
 
-    [[nodiscard]] Token get_identifier() noexcept;
-    [[nodiscard]] Token get_number();
-    [[nodiscard]] Token get_string();
+    constexpr void push_token(std::vector<Token>& tokens, Token&& token) {
+        if constexpr (profiling_enabled) {
+            m_profiler.count_token(token.type);
+            m_profiler.count_allocation(tokens.size() == tokens.capacity());
+            m_profiler.count_allocation(
+                token.lexeme.has_value() &&
+                token.lexeme->capacity() > std::string{}.capacity());
+        }
 
-    [[nodiscard]] Token get_token();
+        tokens.push_back(std::move(token));
+    }
 
-    std::string_view::iterator m_at{};
-    std::string_view::iterator m_end{};
+    const char* m_begin = nullptr;
+    const char* m_at = nullptr;
+    const char* m_end = nullptr;
+
+    ChunkReader* m_reader = nullptr;
+    std::uint32_t m_base_offset = 0;
 
     std::string m_filename;
     Position m_position{};
+    bool m_track_positions = true;
 
     bool m_can_parse_long_token = false;
+
+    std::size_t m_error_count = 0;
+
+    ParseOptions m_options;
+    [[no_unique_address]] details::Profiler<> m_profiler;
 };
 
+constexpr std::vector<Token>
+Lexer::lex(std::string_view source, std::string_view filename) {
+    std::vector<Token> result;
+    lex(source, filename, result);
+
+    return result;
+}
+
+inline std::vector<Token>
+Lexer::lex(ChunkReader& reader, std::string_view filename) {
+    std::vector<Token> result;
+
+    start(reader, filename);
+    next(result, static_cast<std::size_t>(-1));
+
+    return result;
+}
+
+constexpr void Lexer::lex(
+    std::string_view source, std::string_view filename,
+    std::vector<Token>& tokens) {
+    m_begin = source.data();
+    m_at = m_begin;
+    m_end = m_begin + source.size();
+
+    m_reader = nullptr;
+    m_filename = filename;
+
+    tokens.clear();
+
+    start();
+    next(tokens, static_cast<std::size_t>(-1));
+}
+
+inline void Lexer::start(ChunkReader& reader, std::string_view filename) {
+    m_begin = nullptr;
+    m_at = nullptr;
+    m_end = nullptr;
+
+    m_reader = &reader;
+    m_filename = filename;
+
+    start();
+}
+
+constexpr void Lexer::start() {
+    m_profiler.start(PhaseProfile::Phase::Lex, m_options.profile_sink);
+
+    m_base_offset = 0;
+    m_track_positions = m_options.track_positions || m_reader != nullptr;
+
+    m_position = {1, 1};
+
+    m_can_parse_long_token = true;
+
+    skip_useless();
+}
+
+constexpr void Lexer::next(std::vector<Token>& tokens, std::size_t count) {
+    for (; count > 0 && !at_end(); --count) {
+        auto error_count = m_error_count;
+        auto token = get_token();
+
+        if (m_error_count != error_count) {
+            token.type = Token::Type::Invalid;
+        }
+
+        push_token(tokens, std::move(token));
+        skip_useless();
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    push_token(
+        tokens, {{position(), position(1)}, Token::Type::Eof});
+
+    m_profiler.count_consumed(position().offset);
+    m_profiler.finish();
+}
+
+constexpr Token Lexer::get_identifier() {
+    std::string result;
+    auto begin = position();
+
+    while (!at_end() && (is_alphanumeric(at()) || at() == '-' || at() == '_')) {
+        result += eat();
+    }
+
+    m_can_parse_long_token = false;
+
+    return {
+        {begin, position()},
+        (result == "true" || result == "false") ? Token::Type::Boolean
+                                                : Token::Type::Identifier,
+        result};
+}
+
+constexpr Token Lexer::get_number() {
+    std::string result;
+    auto begin = position();
+
+    auto get_if_e = [&] {
+        if (at_end() || at() != 'e') {
+            return false;
+        }
+
+        result += eat();
+
+        if (!at_end() && (at() == '-' || at() == '+')) {
+            result += eat();
+        }
+
+        result += get_integer();
+
+        return true;
+    };
+
+    m_can_parse_long_token = false;
+
+    if (at() == '0') {
+        result += eat();
+
+        if (at_end()) {
+            return {{begin, position()}, Token::Type::Integer, result};
+        }
+
+        if (details::swar::is_digit<10>(at()) || at() == '_') {
+            auto leading_zero_position = position(-1);
+
+            fail(
+                "leading zeros are not allowed",
+                {leading_zero_position, leading_zero_position});
+
+            // Takes the whole number, so that lexing resumes after it.
+            result += get_integer();
+
+            return {{begin, position()}, Token::Type::Integer, result};
+        }
+
+        switch (at()) {
+        case 'x':
+            result += eat();
+            result += get_integer<16>();
+
+            return {{begin, position()}, Token::Type::Integer, result};
+        case 'o':
+            result += eat();
+            result += get_integer<8>();
+
+            return {{begin, position()}, Token::Type::Integer, result};
+        case 'b':
+            result += eat();
+            result += get_integer<2>();
+
+            return {{begin, position()}, Token::Type::Integer, result};
+        case '.':
+            result += eat();
+            result += get_integer();
+
+            get_if_e();
+
+            return {{begin, position()}, Token::Type::Float, result};
+        default:
+            return {{begin, position()}, Token::Type::Integer, result};
+        }
+    } else {
+        if (at() == '+') {
+            eat();
+        } else if (at() == '-') {
+            result += eat();
+        }
+    }
+
+    result += get_integer();
+
+    if (!at_end() && at() == '.') {
+        result += eat();
+        result += get_integer();
+
+        get_if_e();
+
+        return {{begin, position()}, Token::Type::Float, result};
+    }
+
+    if (get_if_e()) {
+        return {{begin, position()}, Token::Type::Float, result};
+    }
+
+    return {{begin, position()}, Token::Type::Integer, result};
+}
+
+constexpr Token Lexer::get_string() {
+    std::string result;
+    char quote = eat();
+    auto begin = position();
+
+    auto is_unclosed = [this, begin] {
+        if (!at_end()) {
+            return false;
+        }
+
+        fail("unterminated string", {begin, position(-1)});
+
+        return true;
+    };
+
+    while (true) {
+        auto plain = count_plain_characters(quote);
+        result.append(m_at, plain);
+        advance(plain);
+
+        if (is_unclosed()) {
+            break;
+        }
+
+        if (at() == quote) {
+            eat();
+            break;
+        }
+
+        if (at() == '\\') {
+            eat();
+
+            if (is_unclosed()) {
+                break;
+            }
+
+            get_escape(result);
+        } else if (at() == '\n') {
+            result += eat();
+        } else {
+            get_utf8_sequence(result);
+        }
+    }
+
+    m_can_parse_long_token = false;
+
+    return {
+        {begin, position(-1)},
+        Token::Type::String,
+        result};
+}
+
+constexpr void Lexer::get_escape(std::string& result) {
+    auto begin = position(-1);
+
+    switch (at()) {
+    case 'n':
+        result += '\n';
+        break;
+    case 'r':
+        result += '\r';
+        break;
+    case 't':
+        result += '\t';
+        break;
+    case 'u':
+    case 'U': {
+        auto digits = eat() == 'u' ? 4 : 8;
+        std::uint32_t code_point = 0;
+
+        for (; digits > 0; --digits) {
+            if (at_end() || !details::swar::is_digit<16>(at())) {
+                fail("invalid unicode escape sequence", {begin, position()});
+
+                return;
+            }
+
+            auto digit = eat();
+            code_point = code_point * 16 +
+                         static_cast<std::uint32_t>(
+                             digit <= '9' ? digit - '0'
+                                          : (digit | 0x20) - 'a' + 10);
+        }
+
+        if (!details::utf8::is_scalar_value(code_point)) {
+            fail(
+                "escaped code point is not a unicode scalar value",
+                {begin, position(-1)});
+
+            return;
+        }
+
+        details::utf8::append(result, code_point);
+        return;
+    }
+    default:
+        // Any other character stands for itself.
+        if (details::utf8::sequence_length(at()) != 1) {
+            get_utf8_sequence(result);
+            return;
+        }
+
+        result += at();
+        break;
+    }
+
+    eat();
+}
+
+constexpr void Lexer::get_utf8_sequence(std::string& result) {
+    auto begin = position();
+    auto length = details::utf8::sequence_length(at());
+    auto [low, high] = details::utf8::second_byte_range(at());
+
+    auto fail_invalid = [this, begin] {
+        fail("invalid UTF-8", {begin, position()});
+    };
+
+    if (length == 0) {
+        fail_invalid();
+        eat();
+
+        return;
+    }
+
+    result += eat();
+
+    for (std::size_t i = 1; i < length; ++i) {
+        if (at_end()) {
+            fail_invalid();
+            return;
+        }
+
+        auto byte = static_cast<unsigned char>(at());
+
+        if (byte < low || byte > high) {
+            fail_invalid();
+            return;
+        }
+
+        result += eat();
+
+        low = 0x80;
+        high = 0xbf;
+    }
+}
+
+constexpr Token Lexer::get_token() {
+    if (m_can_parse_long_token) {
+        if (is_alpha(at()) || at() == '_') {
+            return get_identifier();
+        }
+
+        if (details::swar::is_digit<10>(at()) || at() == '+' || at() == '-') {
+            return get_number();
+        }
+
+        if (at() == '"' || at() == '\'') {
+            return get_string();
+        }
+
+        if (at() == '`') {
+            auto token = get_string();
+            return {
+                token.source, Token::Type::Identifier, std::move(token.lexeme)};
+        }
+    }
+
+    auto begin = position();
+
+    Token::Type type = [this, begin] {
+        char character = eat();
+
+        switch (character) {
+        case '=':
+            return Token::Type::Equal;
+        case ';':
+            return Token::Type::Semicolon;
+        case ',':
+            return Token::Type::Comma;
+        case '.':
+            return Token::Type::Dot;
+        case '[':
+            return Token::Type::LeftBracket;
+        case ']':
+            return Token::Type::RightBracket;
+        case '{':
+            return Token::Type::LeftBrace;
+        case '}':
+            return Token::Type::RightBrace;
+        case '\n':
+            if (!at_end() && at() == '\r') {
+                eat();
+            }
+
+            return Token::Type::LineBreak;
+        }
+
+        fail(std::string{"unexpected '"} + character + "'", {begin, begin});
+
+        return Token::Type::Invalid;
+    }();
+
+    m_can_parse_long_token = true;
+
+    return {{begin, begin}, type};
+}
+
 } // namespace lumen
 
 #endif
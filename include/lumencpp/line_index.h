@@ -0,0 +1,67 @@
+#ifndef LUMENCPP_LINE_INDEX_H
+#define LUMENCPP_LINE_INDEX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "position.h"
+#include "source_region.h"
+
+namespace lumen {
+
+class LineIndex {
+public:
+    [[nodiscard]] explicit LineIndex(std::string_view source) noexcept
+    : m_source{source} {}
+
+    [[nodiscard]] Position resolve(Position position) {
+        if (m_line_offsets.empty()) {
+            build();
+        }
+
+        auto next = std::upper_bound(
+            m_line_offsets.begin(), m_line_offsets.end(), position.offset);
+
+        position.line =
+            static_cast<std::uint32_t>(next - m_line_offsets.begin());
+        position.column = position.offset - *(next - 1) + 1;
+
+        return position;
+    }
+
+    [[nodiscard]] SourceRegion resolve(SourceRegion region) {
+        return {resolve(region.begin), resolve(region.end)};
+    }
+
+private:
+    void build() {
+        m_line_offsets.push_back(0);
+
+        // memchr is vectorized by every mainstream C library, which makes
+        // building the index on large inputs bound by memory bandwidth.
+        const auto* begin = m_source.data();
+        const auto* end = begin + m_source.size();
+
+        for (const auto* at = begin; at != end;) {
+            const auto* line_break = static_cast<const char*>(
+                std::memchr(at, '\n', static_cast<std::size_t>(end - at)));
+
+            if (line_break == nullptr) {
+                break;
+            }
+
+            at = line_break + 1;
+            m_line_offsets.push_back(static_cast<std::uint32_t>(at - begin));
+        }
+    }
+
+    std::string_view m_source;
+    std::vector<std::uint32_t> m_line_offsets;
+};
+
+} // namespace lumen
+
+#endif
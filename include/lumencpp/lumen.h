@@ -1 +1,14 @@
 #include "document.h"
+#include "static_document.h"
+#include "schema.h"
+#include "fingerprint.h"
+#include "document_cache.h"
+#include "json.h"
+#include "string_pool.h"
+#include "async_loader.h"
+#include "mapped_document.h"
+#include "parse_session.h"
+#include "validator.h"
+#include "record_reader.h"
+#include "document_reaper.h"
+#include "cursor.h"
@@ -0,0 +1,69 @@
+#ifndef LUMENCPP_MAPPED_DOCUMENT_H
+#define LUMENCPP_MAPPED_DOCUMENT_H
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+#include "frozen_document.h"
+#include "value_view.h"
+
+namespace lumen {
+
+// A frozen document mapped read-only from a file, such as one under /dev/shm.
+// The file holds the node table and the string pool as they are in memory;
+// both only refer to their own entries by index and offset, so every process
+// that opens the file shares its pages instead of parsing or copying it.
+class MappedDocument {
+public:
+    // An empty root object.
+    [[nodiscard]] MappedDocument() noexcept;
+
+    [[nodiscard]] MappedDocument(MappedDocument&& other) noexcept;
+
+    MappedDocument& operator=(MappedDocument&& other) noexcept;
+
+    ~MappedDocument();
+
+    // Replaces the file atomically, so that a process opening it concurrently
+    // sees either the old or the new document.
+    static void
+    write(const FrozenDocument& document, const std::filesystem::path& path);
+
+    // Checks that every node stays within the file, so that a corrupted or
+    // truncated file throws an IOError here rather than misbehaving later.
+    [[nodiscard]] static MappedDocument open(const std::filesystem::path& path);
+
+    [[nodiscard]] ValueView root() const noexcept {
+        return {m_nodes, m_strings};
+    }
+
+    [[nodiscard]] auto begin() const noexcept { return root().begin(); }
+    [[nodiscard]] auto end() const noexcept { return root().end(); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return root().size(); }
+
+    [[nodiscard]] bool contains(std::string_view key) const {
+        return root().contains(key);
+    }
+
+    [[nodiscard]] ValueView at(std::string_view key) const {
+        return root()[key];
+    }
+
+    [[nodiscard]] ValueView operator[](std::string_view key) const {
+        return root()[key];
+    }
+
+private:
+    void* m_data = nullptr;
+    std::size_t m_size = 0;
+
+    std::span<const details::FlatNode> m_nodes;
+    std::string_view m_strings;
+};
+
+} // namespace lumen
+
+#endif
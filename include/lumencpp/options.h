@@ -0,0 +1,48 @@
+#ifndef LUMENCPP_OPTIONS_H
+#define LUMENCPP_OPTIONS_H
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "exceptions.h"
+#include "profiler.h"
+#include "string_pool.h"
+#include "value.h"
+
+namespace lumen {
+
+struct ParseOptions {
+    // Receives a profile of every phase when the library is built with
+    // LUMENCPP_PROFILING; ignored otherwise.
+    ProfileSink* profile_sink = nullptr;
+
+    // When disabled, tokens only carry byte offsets; use LineIndex to compute
+    // lines and columns on demand.
+    bool track_positions = true;
+
+    // Deepest allowed nesting of arrays and objects.
+    std::size_t max_depth = std::numeric_limits<std::size_t>::max();
+
+    // When set, string values that do not fit into the small-string buffer are
+    // shared through the pool instead of each owning a copy.
+    StringPool* string_pool = nullptr;
+
+    // When set, parsing does not stop at the first error. Every error is
+    // appended here, parsing resumes at the next line break, semicolon, comma
+    // or closing bracket, and the document holds whatever could be parsed;
+    // values that could not are dropped from arrays and left undefined
+    // elsewhere.
+    std::vector<ParseError>* diagnostics = nullptr;
+
+    // Values that identifiers may refer to besides the document's own, shared
+    // read-only by every parse that uses it instead of being copied into each
+    // result. A top-level key of the document shadows one of the same name
+    // here; only values that are referred to, and objects whose members are
+    // assigned to, are copied into the document.
+    const Object* scope = nullptr;
+};
+
+} // namespace lumen
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef LUMENCPP_PARSE_SESSION_H
+#define LUMENCPP_PARSE_SESSION_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "document.h"
+#include "lexer.h"
+#include "options.h"
+#include "parser.h"
+#include "token.h"
+#include "value.h"
+
+namespace lumen {
+
+// Parses one document after another without setting up from scratch each
+// time. The session keeps the token storage, the parser's container stack and
+// its filename buffers between parses, and reserves room in the root object
+// for as many members as the previous document had. It is meant to be kept
+// for a thread's lifetime, e.g. as a thread_local; sharing one session
+// between threads needs a lock.
+class ParseSession {
+public:
+    [[nodiscard]] ParseSession() = default;
+
+    [[nodiscard]] explicit ParseSession(ParseOptions options) noexcept
+    : m_options{options}, m_lexer{options}, m_parser{options} {}
+
+    [[nodiscard]] Document parse(
+        std::string_view source, std::string_view filename = "<string>",
+        Object predefined = {});
+
+    // Releases the memory kept between parses.
+    void clear();
+
+    [[nodiscard]] const ParseOptions& options() const noexcept {
+        return m_options;
+    }
+
+private:
+    ParseOptions m_options;
+
+    Lexer m_lexer;
+    Parser m_parser;
+    std::vector<Token> m_tokens;
+
+    std::size_t m_member_hint = 0;
+};
+
+} // namespace lumen
+
+#endif
@@ -1,81 +1,513 @@
 #ifndef LUMENCPP_PARSER_H
 #define LUMENCPP_PARSER_H
 
+#include <algorithm>
 #include <array>
-#include <stdexcept>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <type_traits>
 #include <vector>
 
 #include "exceptions.h"
+#include "lexer.h"
+#include "options.h"
+#include "profiler.h"
+#include "swar.h"
 #include "token.h"
 #include "value.h"
 
 namespace lumen {
 
+namespace details {
+
+[[nodiscard]] constexpr const char*
+to_string(Token::Type type, bool add_an_article = false) noexcept {
+    switch (type) {
+    case Token::Type::Equal:
+        return "'='";
+    case Token::Type::Semicolon:
+        return "';'";
+    case Token::Type::Comma:
+        return "','";
+    case Token::Type::Dot:
+        return "'.'";
+    case Token::Type::LeftBracket:
+        return "'['";
+    case Token::Type::RightBracket:
+        return "']'";
+    case Token::Type::LeftBrace:
+        return "'{'";
+    case Token::Type::RightBrace:
+        return "'}'";
+    case Token::Type::Identifier:
+        return add_an_article ? "a key" : "key";
+    case Token::Type::Integer:
+        return add_an_article ? "an integer" : "integer";
+    case Token::Type::Boolean:
+        return add_an_article ? "a boolean" : "boolean";
+    case Token::Type::Float:
+        return add_an_article ? "a float" : "float";
+    case Token::Type::String:
+        return add_an_article ? "a string" : "string";
+    case Token::Type::LineBreak:
+        return add_an_article ? "an end of line" : "end of line";
+    case Token::Type::Invalid:
+        return add_an_article ? "an invalid token" : "invalid token";
+    case Token::Type::Eof:
+        return add_an_article ? "an end of file" : "end of file";
+    }
+
+    return "";
+}
+
+// Describes a token that is none of those expected.
+[[nodiscard]] constexpr std::string unexpected_token(
+    Token::Type found, std::initializer_list<Token::Type> expected) {
+    auto message =
+        std::string{"unexpected "} + to_string(found) + "; expected ";
+    std::size_t i = 0;
+
+    for (auto type : expected) {
+        if (i > 0) {
+            message += i == expected.size() - 1 ? " or " : ", ";
+        }
+
+        message += to_string(type, true);
+        ++i;
+    }
+
+    return message;
+}
+
+// Converts the lexeme of an integer token; returns nothing if the value does
+// not fit. Negative integers are always decimal.
+[[nodiscard]] constexpr std::optional<UInt>
+to_unsigned(std::string_view lexeme) noexcept {
+    if (lexeme.starts_with("0x")) {
+        return swar::parse_unsigned<16>(lexeme.substr(2));
+    }
+
+    if (lexeme.starts_with("0o")) {
+        return swar::parse_unsigned<8>(lexeme.substr(2));
+    }
+
+    if (lexeme.starts_with("0b")) {
+        return swar::parse_unsigned<2>(lexeme.substr(2));
+    }
+
+    return swar::parse_unsigned<10>(lexeme);
+}
+
+[[nodiscard]] constexpr std::optional<Int>
+to_signed(std::string_view lexeme) noexcept {
+    bool is_negative = lexeme.starts_with('-');
+
+    if (is_negative) {
+        lexeme.remove_prefix(1);
+    }
+
+    auto magnitude = swar::parse_unsigned<10>(lexeme);
+    auto limit = static_cast<UInt>(std::numeric_limits<Int>::max()) +
+                 static_cast<UInt>(is_negative);
+
+    if (!magnitude.has_value() || *magnitude > limit) {
+        return std::nullopt;
+    }
+
+    return static_cast<Int>(is_negative ? 0 - *magnitude : *magnitude);
+}
+
+
+// Digits of an unsigned integer in base 2^32, least significant first; just
+// enough arithmetic to convert floats during constant evaluation.
+using BigInteger = std::vector<std::uint32_t>;
+
+constexpr void multiply_add(
+    BigInteger& number, std::uint32_t factor, std::uint32_t addend = 0) {
+    std::uint64_t carry = addend;
+
+    for (auto& digit : number) {
+        carry += std::uint64_t{digit} * factor;
+        digit = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+    }
+
+    if (carry != 0) {
+        number.push_back(static_cast<std::uint32_t>(carry));
+    }
+}
+
+constexpr void multiply_by_power_of_ten(BigInteger& number, int exponent) {
+    for (; exponent >= 9; exponent -= 9) {
+        multiply_add(number, 1'000'000'000);
+    }
+
+    for (; exponent > 0; --exponent) {
+        multiply_add(number, 10);
+    }
+}
+
+constexpr void shift_left(BigInteger& number, std::size_t bits) {
+    number.insert(number.begin(), bits / 32, 0);
+    bits %= 32;
+
+    if (bits == 0) {
+        return;
+    }
+
+    std::uint32_t carry = 0;
+
+    for (auto& digit : number) {
+        auto shifted = (digit << bits) | carry;
+        carry = digit >> (32 - bits);
+        digit = shifted;
+    }
+
+    if (carry != 0) {
+        number.push_back(carry);
+    }
+}
+
+constexpr void shift_right_by_one(BigInteger& number) noexcept {
+    for (std::size_t i = 0; i < number.size(); ++i) {
+        number[i] >>= 1;
+
+        if (i + 1 < number.size()) {
+            number[i] |= number[i + 1] << 31;
+        }
+    }
+
+    if (!number.empty() && number.back() == 0) {
+        number.pop_back();
+    }
+}
+
+[[nodiscard]] constexpr std::size_t
+bit_width(const BigInteger& number) noexcept {
+    return number.empty() ? 0
+                          : (number.size() - 1) * 32 +
+                                std::bit_width(number.back());
+}
+
+// Neither number may have leading zero digits.
+[[nodiscard]] constexpr bool
+is_less(const BigInteger& lhs, const BigInteger& rhs) noexcept {
+    if (lhs.size() != rhs.size()) {
+        return lhs.size() < rhs.size();
+    }
+
+    for (auto i = lhs.size(); i-- > 0;) {
+        if (lhs[i] != rhs[i]) {
+            return lhs[i] < rhs[i];
+        }
+    }
+
+    return false;
+}
+
+// Requires lhs >= rhs.
+constexpr void subtract(BigInteger& lhs, const BigInteger& rhs) noexcept {
+    std::uint32_t borrow = 0;
+
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        std::uint64_t subtrahend =
+            std::uint64_t{i < rhs.size() ? rhs[i] : 0} + borrow;
+
+        borrow = lhs[i] < subtrahend ? 1 : 0;
+        lhs[i] = static_cast<std::uint32_t>(
+            (std::uint64_t{borrow} << 32) + lhs[i] - subtrahend);
+    }
+
+    while (!lhs.empty() && lhs.back() == 0) {
+        lhs.pop_back();
+    }
+}
+
+// Converts the lexeme of a float token, rounding to nearest like
+// std::from_chars, which is used outside of constant evaluation; returns
+// nothing if the value overflows or, not being zero, rounds to zero.
+[[nodiscard]] constexpr std::optional<Float>
+to_float(std::string_view lexeme) {
+    if (!std::is_constant_evaluated()) {
+        Float result{};
+        auto [end, error] = std::from_chars(
+            lexeme.data(), lexeme.data() + lexeme.size(), result);
+
+        if (error == std::errc::result_out_of_range) {
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+    bool is_negative = lexeme.starts_with('-');
+    auto sign = UInt{is_negative ? 1U : 0U} << 63;
+
+    // The value is `digits` * 10^exponent.
+    BigInteger digits;
+    std::int64_t digit_count = 0;
+    std::int64_t exponent = 0;
+    std::int64_t trailing_zeros = 0;
+
+    std::size_t at = is_negative ? 1 : 0;
+    bool is_fraction = false;
+
+    for (; at < lexeme.size() && lexeme[at] != 'e'; ++at) {
+        if (lexeme[at] == '.') {
+            is_fraction = true;
+            continue;
+        }
+
+        auto digit = static_cast<std::uint32_t>(lexeme[at] - '0');
+        exponent -= is_fraction ? 1 : 0;
+
+        if (digit_count == 0 && digit == 0) {
+            continue;
+        }
+
+        // Trailing zeros are kept out of the digits, so that they stay short.
+        if (digit == 0) {
+            ++trailing_zeros;
+            continue;
+        }
+
+        for (; trailing_zeros > 0; --trailing_zeros) {
+            multiply_add(digits, 10);
+            ++digit_count;
+        }
+
+        multiply_add(digits, 10, digit);
+        ++digit_count;
+    }
+
+    exponent += trailing_zeros;
+
+    if (at < lexeme.size()) {
+        ++at;
+
+        bool is_exponent_negative = at < lexeme.size() && lexeme[at] == '-';
+        bool has_sign =
+            at < lexeme.size() && (lexeme[at] == '-' || lexeme[at] == '+');
+        at += has_sign ? 1 : 0;
+
+        std::int64_t written_exponent = 0;
+
+        for (; at < lexeme.size(); ++at) {
+            constexpr std::int64_t max_exponent = 1'000'000'000;
+            written_exponent = std::min<std::int64_t>(
+                written_exponent * 10 + (lexeme[at] - '0'), max_exponent);
+        }
+
+        exponent += is_exponent_negative ? -written_exponent : written_exponent;
+    }
+
+    if (digit_count == 0) {
+        return std::bit_cast<Float>(sign);
+    }
+
+    // The value is at least 10^309 or below 10^-324, which rounds to zero.
+    if (digit_count + exponent > 309 || digit_count + exponent <= -324) {
+        return std::nullopt;
+    }
+
+    // numerator / denominator is scaled by 2^shift to have 55 or 56 bits
+    // before the point, two more than needed to round.
+    BigInteger numerator = std::move(digits);
+    BigInteger denominator{1};
+
+    multiply_by_power_of_ten(
+        exponent > 0 ? numerator : denominator,
+        static_cast<int>(exponent > 0 ? exponent : -exponent));
+
+    auto shift = 55 - (static_cast<std::int64_t>(bit_width(numerator)) -
+                       static_cast<std::int64_t>(bit_width(denominator)));
+    shift_left(
+        shift > 0 ? numerator : denominator,
+        static_cast<std::size_t>(shift > 0 ? shift : -shift));
+
+    UInt quotient = 0;
+    shift_left(denominator, 56);
+
+    for (int bit = 55; bit >= 0; --bit) {
+        shift_right_by_one(denominator);
+
+        if (!is_less(numerator, denominator)) {
+            subtract(numerator, denominator);
+            quotient |= UInt{1} << bit;
+        }
+    }
+
+    bool is_inexact = !numerator.empty();
+
+    // The value is quotient * 2^-shift; the lowest bit kept is worth
+    // 2^(binary_exponent - 52), or 2^-1074 for subnormals.
+    auto binary_exponent =
+        static_cast<std::int64_t>(std::bit_width(quotient)) - 1 - shift;
+    bool is_subnormal = binary_exponent < -1022;
+    auto dropped = std::max<std::int64_t>(binary_exponent, -1022) - 52 + shift;
+
+    UInt mantissa = 0;
+
+    if (dropped < 64) {
+        auto remainder = quotient & ((UInt{1} << dropped) - 1);
+        auto half = UInt{1} << (dropped - 1);
+
+        mantissa = quotient >> dropped;
+
+        if (remainder > half ||
+            (remainder == half && (is_inexact || (mantissa & 1) != 0))) {
+            ++mantissa;
+        }
+    }
+
+    if (mantissa == 0) {
+        return std::nullopt;
+    }
+
+    // A subnormal that rounds up to 2^52 is encoded as the least normal.
+    if (is_subnormal) {
+        return std::bit_cast<Float>(sign | mantissa);
+    }
+
+    if (mantissa == UInt{1} << 53) {
+        mantissa >>= 1;
+        ++binary_exponent;
+    }
+
+    if (binary_exponent > 1023) {
+        return std::nullopt;
+    }
+
+    auto biased_exponent = static_cast<UInt>(binary_exponent + 1023);
+
+    return std::bit_cast<Float>(
+        sign | (biased_exponent << 52) | (mantissa - (UInt{1} << 52)));
+}
+
+} // namespace details
+
 class Parser {
 public:
+    [[nodiscard]] Parser() = default;
+
+    [[nodiscard]] explicit Parser(ParseOptions options) noexcept
+    : m_options{options} {}
+
     [[nodiscard]] Object parse(
-        const std::vector<Token>& tokens, std::string filename,
+        const std::vector<Token>& tokens, std::string_view filename,
+        Object predefined = {});
+
+    // Pulls the tokens from the lexer a batch at a time as the parse goes,
+    // so that however long the input is, no more than two batches of tokens
+    // are held at once.
+    [[nodiscard]] Object parse(
+        Lexer& lexer, ChunkReader& reader, std::string_view filename,
         Object predefined = {});
 
 private:
-    [[nodiscard]] auto at() const noexcept { return *m_at; }
+    static constexpr std::size_t batch_size = 1024;
+
+    [[nodiscard]] Object parse_statements(Object predefined);
+
+    [[nodiscard]] const Token& at() const noexcept { return *m_at; }
 
     [[nodiscard]] bool at_end() const noexcept {
         return at().type == Token::Type::Eof;
     }
 
-    auto eat() noexcept { return *(m_at++); }
+    const Token& eat() {
+        m_profiler.count_token(m_at->type);
+        const auto& result = *(m_at++);
 
-    template <Token::Type First, Token::Type... Expected> auto expect() {
-        auto result = eat();
+        if (m_at == m_end && m_lexer != nullptr &&
+            result.type != Token::Type::Eof) {
+            next_batch();
+        }
 
-        if (result.type != First && ((result.type != Expected) && ...)) {
-            auto message = std::string{"unexpected "} + to_string(result.type) +
-                           "; expected " + to_string(First, true);
+        return result;
+    }
 
-            if constexpr (sizeof...(Expected) > 0) {
-                std::array expected_array{Expected...};
+    // Lexes the next batch into the buffer not in use. The token just eaten
+    // stays where it is, and is repeated at the front of the batch for
+    // expect() to step back onto.
+    void next_batch();
 
-                for (std::size_t i = 0; i < expected_array.size(); ++i) {
-                    if (i == expected_array.size() - 1) {
-                        message += " or ";
-                    } else {
-                        message += ", ";
-                    }
+    // Throws, unless the options ask to recover from errors; then the caller
+    // returns early and the parse resumes at the next boundary.
+    void fail(ParseError error) {
+        if (m_options.diagnostics == nullptr) {
+            throw error;
+        }
 
-                    message += to_string(expected_array[i], true);
-                }
+        m_options.diagnostics->push_back(std::move(error));
+        m_failed = true;
+    }
+
+    template <Token::Type First, Token::Type... Expected>
+    const Token& expect() {
+        const auto& result = eat();
+
+        if (result.type != First && ((result.type != Expected) && ...)) {
+            // Leaves the token for error recovery to resume at.
+            --m_at;
+
+            // The lexer has reported the error already.
+            if (result.type == Token::Type::Invalid) {
+                m_failed = true;
+                return result;
             }
 
-            throw ParseError{message, m_filename, result.source};
+            fail(ParseError{
+                details::unexpected_token(result.type, {First, Expected...}),
+                m_filename, result.source});
         }
 
         return result;
     }
 
-    void skip_line_breaks() noexcept {
+    void skip_line_breaks() {
         while (!at_end() && at().type == Token::Type::LineBreak) {
             eat();
         }
     }
 
-    [[nodiscard]] Value& parse_key_path(
-        Object& parent, const Token& token, bool create_if_not_exist = true);
+    // Returns null if there is no such member or it is undefined.
+    [[nodiscard]] static const Value*
+    find(const Object& object, const std::string& key) {
+        auto found = object.find(key);
 
-    [[nodiscard]] Value&
-    parse_key_path(Object& parent, bool create_if_not_exist = true) {
-        return parse_key_path(
-            parent, expect<Token::Type::Identifier>(), create_if_not_exist);
+        return found != object.end() &&
+                       found->second.get_type() != Value::Type::Undefined
+                   ? &found->second
+                   : nullptr;
     }
 
-    [[nodiscard]] auto get_token_lexeme(const Token& token) {
+    [[nodiscard]] Value& parse_key_path(Object& parent, const Token& token);
+
+    [[nodiscard]] Value& parse_key_path(Object& parent) {
+        return parse_key_path(parent, expect<Token::Type::Identifier>());
+    }
+
+    // Resolves an identifier used as a value, in the document and then in
+    // the scope.
+    [[nodiscard]] const Value& parse_reference(const Token& token);
+
+    [[nodiscard]] const std::string& get_token_lexeme(const Token& token) {
         if (!token.lexeme.has_value()) {
-            throw ParseError{
-                std::string{to_string(token.type, true)} +
+            fail(ParseError{
+                std::string{details::to_string(token.type, true)} +
                     " token must have a value",
-                std::move(m_filename), token.source};
+                m_filename, token.source});
+
+            static const std::string missing;
+            return missing;
         }
 
         return *token.lexeme;
@@ -84,105 +516,114 @@ private:
     template <std::same_as<UInt>>
     [[nodiscard]] UInt
     from_string(SourceRegion source, const std::string& value) {
-        try {
-            if (value.starts_with("0x")) {
-                constexpr auto base = 16;
-                return std::stoull(value, nullptr, base);
-            }
+        m_profiler.count_numeric_conversion();
 
-            if (value.starts_with("0o")) {
-                constexpr auto base = 8;
-                return std::stoull(value.substr(2), nullptr, base);
-            }
+        auto result = details::to_unsigned(value);
 
-            if (value.starts_with("0b")) {
-                constexpr auto base = 2;
-                return std::stoull(value.substr(2), nullptr, base);
-            }
+        if (!result.has_value()) {
+            fail(ParseError{
+                "integer '" + value + "' is out of range", m_filename,
+                source});
 
-            constexpr auto base = 10;
-            return std::stoull(value, nullptr, base);
-        } catch (const std::out_of_range&) {
-            throw ParseError{
-                "integer '" + value + "' is out of range",
-                std::move(m_filename), source};
+            return 0;
         }
+
+        return *result;
     }
 
     template <std::same_as<Int>>
     [[nodiscard]] Int
     from_string(SourceRegion source, const std::string& value) {
-        try {
-            return std::stoll(value);
-        } catch (const std::out_of_range&) {
-            throw ParseError{
-                "integer '" + value + "' is out of range",
-                std::move(m_filename), source};
+        m_profiler.count_numeric_conversion();
+
+        auto result = details::to_signed(value);
+
+        if (!result.has_value()) {
+            fail(ParseError{
+                "integer '" + value + "' is out of range", m_filename,
+                source});
+
+            return 0;
         }
+
+        return *result;
     }
 
     template <std::same_as<Float>>
     [[nodiscard]] Float
     from_string(SourceRegion source, const std::string& value) {
-        try {
-            return std::stod(value);
-        } catch (const std::out_of_range&) {
-            throw ParseError{
-                "float '" + value + "' is out of range", std::move(m_filename),
-                source};
+        m_profiler.count_numeric_conversion();
+
+        auto result = details::to_float(value);
+
+        if (!result.has_value()) {
+            fail(ParseError{
+                "float '" + value + "' is out of range", m_filename, source});
+
+            return 0;
         }
+
+        return *result;
     }
 
-    [[nodiscard]] Array parse_array();
-    [[nodiscard]] Object parse_object();
+    // An array or object being parsed. Nesting is tracked on an explicit
+    // stack instead of by recursion, so deep documents cannot overflow the
+    // call stack.
+    struct Frame {
+        bool is_object = false;
+
+        Object object;
+        Value* target = nullptr;
+
+        Array array;
+
+        // Stays in use for as long as every element is a scalar of the same
+        // type.
+        PackedArray packed;
+        bool is_packed = true;
+    };
+
+    [[nodiscard]] Frame& top() noexcept { return m_stack[m_depth - 1]; }
+
+    void open(const Token& token);
+    void add(Value&& value);
+    [[nodiscard]] bool next_element();
+    [[nodiscard]] Value close();
+
+    void skip_to_boundary();
+    [[nodiscard]] bool recover();
+    void skip_statement();
+
     [[nodiscard]] Value parse_integer(const Token& token);
+    [[nodiscard]] Value parse_scalar(const Token& token);
 
     [[nodiscard]] Value parse_value();
     void parse_assignment(Object& parent);
 
-    [[nodiscard]] static constexpr const char*
-    to_string(Token::Type type, bool add_an_article = false) noexcept {
-        switch (type) {
-        case Token::Type::Equal:
-            return "'='";
-        case Token::Type::Semicolon:
-            return "';'";
-        case Token::Type::Comma:
-            return "','";
-        case Token::Type::Dot:
-            return "'.'";
-        case Token::Type::LeftBracket:
-            return "'['";
-        case Token::Type::RightBracket:
-            return "']'";
-        case Token::Type::LeftBrace:
-            return "'{'";
-        case Token::Type::RightBrace:
-            return "'}'";
-        case Token::Type::Identifier:
-            return add_an_article ? "a key" : "key";
-        case Token::Type::Integer:
-            return add_an_article ? "an integer" : "integer";
-        case Token::Type::Boolean:
-            return add_an_article ? "a boolean" : "boolean";
-        case Token::Type::Float:
-            return add_an_article ? "a float" : "float";
-        case Token::Type::String:
-            return add_an_article ? "a string" : "string";
-        case Token::Type::LineBreak:
-            return add_an_article ? "an end of line" : "end of line";
-        case Token::Type::Eof:
-            return add_an_article ? "an end of file" : "end of file";
-        }
-
-        return "";
-    }
-
     Object m_data;
 
     std::string m_filename;
 
-    std::vector<Token>::const_iterator m_at;
+    const Token* m_at = nullptr;
+    const Token* m_end = nullptr;
+
+    // Set while tokens are pulled from a lexer, into the buffer at m_batch.
+    Lexer* m_lexer = nullptr;
+    std::array<std::vector<Token>, 2> m_batches;
+    std::size_t m_batch = 0;
+
+    // Frames past the current depth are kept to be reused.
+    std::vector<Frame> m_stack;
+    std::size_t m_depth = 0;
+
+    // Set by an error that is being recovered from.
+    bool m_failed = false;
+
+    // Stands in for a key path that could not be resolved.
+    Value m_undefined;
+
+    ParseOptions m_options;
+    [[no_unique_address]] details::Profiler<> m_profiler;
 };
 
 } // namespace lumen
@@ -8,6 +8,8 @@ namespace lumen {
 struct Position {
     std::uint32_t line = 1;
     std::uint32_t column = 1;
+
+    std::uint32_t offset = 0;
 };
 
 } // namespace lumen
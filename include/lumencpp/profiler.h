@@ -0,0 +1,118 @@
+#ifndef LUMENCPP_PROFILER_H
+#define LUMENCPP_PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "token.h"
+
+namespace lumen {
+
+#ifdef LUMENCPP_PROFILING
+inline constexpr bool profiling_enabled = true;
+#else
+inline constexpr bool profiling_enabled = false;
+#endif
+
+struct PhaseProfile {
+    enum struct Phase : std::uint8_t { Lex, Parse };
+
+    static constexpr std::size_t token_type_count =
+        static_cast<std::size_t>(Token::Type::Eof) + 1;
+
+    [[nodiscard]] auto token_count(Token::Type type) const noexcept {
+        return tokens[static_cast<std::size_t>(type)];
+    }
+
+    Phase phase = Phase::Lex;
+    std::chrono::nanoseconds duration{};
+
+    // Bytes of source consumed by the lexer, tokens consumed by the parser.
+    std::size_t consumed = 0;
+
+    std::array<std::size_t, token_type_count> tokens{};
+
+    // Heap allocations performed by the phase (token storage, lexemes,
+    // containers and strings that do not fit into the small buffer).
+    std::size_t allocations = 0;
+
+    std::size_t numeric_conversions = 0;
+    std::size_t key_path_resolutions = 0;
+};
+
+struct ProfileSink {
+    virtual ~ProfileSink() = default;
+
+    virtual void record(const PhaseProfile& profile) = 0;
+};
+
+namespace details {
+
+template <bool Enabled = profiling_enabled> class Profiler {
+public:
+    constexpr void start(PhaseProfile::Phase, ProfileSink*) noexcept {}
+    constexpr void finish() noexcept {}
+
+    constexpr void count_consumed(std::size_t) noexcept {}
+    constexpr void count_token(Token::Type) noexcept {}
+    constexpr void count_allocation(bool = true) noexcept {}
+    constexpr void count_numeric_conversion() noexcept {}
+    constexpr void count_key_path_resolution() noexcept {}
+};
+
+template <> class Profiler<true> {
+public:
+    constexpr void
+    start(PhaseProfile::Phase phase, ProfileSink* sink) noexcept {
+        m_sink = sink;
+        m_profile = {};
+        m_profile.phase = phase;
+
+        if (m_sink != nullptr) {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    constexpr void finish() {
+        if (m_sink == nullptr) {
+            return;
+        }
+
+        m_profile.duration = std::chrono::steady_clock::now() - m_start;
+        m_sink->record(m_profile);
+    }
+
+    constexpr void count_consumed(std::size_t amount) noexcept {
+        m_profile.consumed += amount;
+    }
+
+    constexpr void count_token(Token::Type type) noexcept {
+        ++m_profile.tokens[static_cast<std::size_t>(type)];
+    }
+
+    constexpr void count_allocation(bool allocated = true) noexcept {
+        m_profile.allocations += static_cast<std::size_t>(allocated);
+    }
+
+    constexpr void count_numeric_conversion() noexcept {
+        ++m_profile.numeric_conversions;
+    }
+
+    constexpr void count_key_path_resolution() noexcept {
+        ++m_profile.key_path_resolutions;
+    }
+
+private:
+    ProfileSink* m_sink = nullptr;
+    std::chrono::steady_clock::time_point m_start;
+
+    PhaseProfile m_profile;
+};
+
+} // namespace details
+
+} // namespace lumen
+
+#endif
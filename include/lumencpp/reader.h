@@ -0,0 +1,80 @@
+#ifndef LUMENCPP_READER_H
+#define LUMENCPP_READER_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "exceptions.h"
+
+namespace lumen {
+
+class ChunkReader {
+public:
+    // Fills the buffer with up to `size` bytes and returns how many were
+    // written; returning zero marks the end of the input.
+    using Read = std::function<std::size_t(char* buffer, std::size_t size)>;
+
+    static constexpr std::size_t default_chunk_size = 64 * 1024;
+
+    [[nodiscard]] explicit ChunkReader(
+        Read read, std::size_t chunk_size = default_chunk_size)
+    : m_read{std::move(read)}, m_buffer(chunk_size == 0 ? 1 : chunk_size) {}
+
+    [[nodiscard]] static ChunkReader from_stream(
+        std::istream& stream, std::size_t chunk_size = default_chunk_size) {
+        return ChunkReader{
+            [&stream](char* buffer, std::size_t size) -> std::size_t {
+                stream.read(buffer, static_cast<std::streamsize>(size));
+
+                if (stream.bad()) {
+                    throw IOError{"failed to read from a stream"};
+                }
+
+                return static_cast<std::size_t>(stream.gcount());
+            },
+            chunk_size};
+    }
+
+    [[nodiscard]] static ChunkReader
+    from_fd(int fd, std::size_t chunk_size = default_chunk_size) {
+        return ChunkReader{
+            [fd](char* buffer, std::size_t size) -> std::size_t {
+                while (true) {
+                    auto result = ::read(fd, buffer, size);
+
+                    if (result >= 0) {
+                        return static_cast<std::size_t>(result);
+                    }
+
+                    if (errno != EINTR) {
+                        throw IOError{
+                            std::string{"failed to read from a file "
+                                        "descriptor: "} +
+                            std::strerror(errno)};
+                    }
+                }
+            },
+            chunk_size};
+    }
+
+    [[nodiscard]] std::string_view next() {
+        return {m_buffer.data(), m_read(m_buffer.data(), m_buffer.size())};
+    }
+
+private:
+    Read m_read;
+    std::vector<char> m_buffer;
+};
+
+} // namespace lumen
+
+#endif
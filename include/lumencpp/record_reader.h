@@ -0,0 +1,165 @@
+#ifndef LUMENCPP_RECORD_READER_H
+#define LUMENCPP_RECORD_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "document.h"
+#include "options.h"
+#include "parse_session.h"
+
+namespace lumen {
+
+// Reads a file or stream of documents separated by lines of "---", one record
+// at a time. Memory use is bounded by the largest record rather than by the
+// input, and every record is parsed with the same ParseSession. Empty records
+// are skipped. A separator line inside a multi-line string is taken as a
+// separator, since records are split before they are lexed.
+//
+// Every index_interval-th record has its offset kept in a sparse index, which
+// seek() uses to jump near a record and skip the rest without parsing them.
+class RecordReader {
+public:
+    static constexpr std::string_view separator = "---";
+
+    struct Options {
+        // Bytes read from the input at a time.
+        std::size_t chunk_size = 256 * 1024;
+
+        std::size_t index_interval = 1024;
+
+        ParseOptions parse_options;
+    };
+
+    class Iterator;
+
+    [[nodiscard]] explicit RecordReader(const std::filesystem::path& path)
+    : RecordReader{path, Options{}} {}
+
+    [[nodiscard]] RecordReader(
+        const std::filesystem::path& path, Options options);
+
+    // A stream can only be read forward, so seek() can not go back in it.
+    [[nodiscard]] explicit RecordReader(std::istream& stream)
+    : RecordReader{stream, Options{}} {}
+
+    [[nodiscard]] RecordReader(std::istream& stream, Options options);
+
+    RecordReader(const RecordReader&) = delete;
+    RecordReader& operator=(const RecordReader&) = delete;
+
+    ~RecordReader();
+
+    // Parses the next record; returns nothing at the end of the input.
+    [[nodiscard]] std::optional<Document> next();
+
+    // Moves past the next record without parsing it; returns false at the
+    // end of the input.
+    bool skip();
+
+    // Moves to the record with the given number, counted from zero. Skips
+    // forward from the closest indexed record before it, or from the current
+    // one if that is closer; throws an IOError if a stream would have to go
+    // back.
+    void seek(std::uint64_t record);
+
+    // Number and byte offset of the next record.
+    [[nodiscard]] std::uint64_t record() const noexcept { return m_record; }
+    [[nodiscard]] std::uint64_t offset() const noexcept { return m_offset; }
+
+    // Offsets of records 0, index_interval, 2 * index_interval and so on, as
+    // far as the input has been read. An index saved from an earlier reader
+    // with the same interval can be restored to seek without a first scan.
+    [[nodiscard]] const std::vector<std::uint64_t>& index() const noexcept {
+        return m_index;
+    }
+
+    void set_index(std::vector<std::uint64_t> index) {
+        m_index = std::move(index);
+    }
+
+    [[nodiscard]] Iterator begin();
+    [[nodiscard]] std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    // Returns the next non-empty record, valid until the buffer changes.
+    [[nodiscard]] std::optional<std::string_view> read_record();
+
+    // Returns the position of the first separator line after `from` and its
+    // length, or the position from which to search again once more input is
+    // read, with a length of zero.
+    [[nodiscard]] std::pair<std::size_t, std::size_t>
+    find_separator(std::size_t from) const noexcept;
+
+    // Appends up to chunk_size bytes; returns false at the end of the input.
+    bool fill();
+
+    void consume(std::size_t size) noexcept;
+
+    Options m_options;
+
+    int m_file = -1;
+    std::istream* m_stream = nullptr;
+    std::string m_filename;
+
+    std::vector<char> m_buffer;
+    std::size_t m_begin = 0;
+    std::size_t m_end = 0;
+    bool m_is_exhausted = false;
+
+    std::uint64_t m_record = 0;
+    std::uint64_t m_offset = 0;
+    std::vector<std::uint64_t> m_index;
+
+    ParseSession m_session;
+};
+
+// Parses records on increment, so each one is read once.
+class RecordReader::Iterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Document;
+    using difference_type = std::ptrdiff_t;
+
+    [[nodiscard]] Iterator() = default;
+
+    [[nodiscard]] explicit Iterator(RecordReader& reader)
+    : m_reader{&reader}, m_document{reader.next()} {}
+
+    [[nodiscard]] Document& operator*() const noexcept {
+        return *m_document;
+    }
+
+    [[nodiscard]] Document* operator->() const noexcept {
+        return &*m_document;
+    }
+
+    Iterator& operator++() {
+        m_document = m_reader->next();
+        return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    [[nodiscard]] bool operator==(std::default_sentinel_t) const noexcept {
+        return !m_document.has_value();
+    }
+
+private:
+    RecordReader* m_reader = nullptr;
+    mutable std::optional<Document> m_document;
+};
+
+inline RecordReader::Iterator RecordReader::begin() { return Iterator{*this}; }
+
+} // namespace lumen
+
+#endif
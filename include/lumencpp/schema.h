@@ -0,0 +1,168 @@
+#ifndef LUMENCPP_SCHEMA_H
+#define LUMENCPP_SCHEMA_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "document.h"
+#include "exceptions.h"
+#include "fixed_string.h"
+#include "value.h"
+
+namespace lumen {
+
+namespace details {
+
+[[nodiscard]] constexpr std::uint64_t
+seeded_hash(std::string_view key, std::uint64_t seed) noexcept {
+    auto result = 0xcbf29ce484222325 ^ seed;
+
+    for (auto character : key) {
+        result ^= static_cast<unsigned char>(character);
+        result *= 0x100000001b3;
+    }
+
+    return result ^ (result >> 32);
+}
+
+// Maps every key of a fixed set to a distinct bucket, so a lookup costs one
+// hash and one comparison.
+template <std::size_t Size> struct PerfectHash {
+    static constexpr std::size_t bucket_count =
+        std::bit_ceil(Size * 2 > 0 ? Size * 2 : 1);
+
+    consteval explicit PerfectHash(
+        const std::array<std::string_view, Size>& keys) {
+        for (std::size_t i = 0; i < Size; ++i) {
+            for (std::size_t j = 0; j < i; ++j) {
+                if (keys[i] == keys[j]) {
+                    throw std::invalid_argument{"duplicate schema key"};
+                }
+            }
+        }
+
+        for (; seed < max_seed; ++seed) {
+            buckets.fill(Size);
+
+            bool is_perfect = true;
+
+            for (std::size_t i = 0; i < Size && is_perfect; ++i) {
+                auto& bucket = buckets[bucket_of(keys[i])];
+                is_perfect = bucket == Size;
+                bucket = i;
+            }
+
+            if (is_perfect) {
+                return;
+            }
+        }
+
+        throw std::invalid_argument{"unable to find a perfect hash"};
+    }
+
+    [[nodiscard]] constexpr std::size_t
+    bucket_of(std::string_view key) const noexcept {
+        return seeded_hash(key, seed) & (bucket_count - 1);
+    }
+
+    static constexpr std::uint64_t max_seed = 1 << 16;
+
+    std::uint64_t seed = 0;
+    std::array<std::size_t, bucket_count> buckets{};
+};
+
+} // namespace details
+
+enum struct UnknownKeys { Collect, Reject };
+
+// A document with a fixed set of top-level keys, each stored in its own slot:
+//
+//     using Config = lumen::Schema<"host", "port", "timeout">;
+//
+//     Config config{lumen::parse_file("app.lumen")};
+//     auto port = config.get<"port">().get<int>();
+template <details::FixedString... Keys> class Schema {
+public:
+    static constexpr std::size_t size = sizeof...(Keys);
+    static constexpr std::size_t npos = size;
+
+    static constexpr std::array<std::string_view, size> keys{Keys.view()...};
+
+    [[nodiscard]] Schema() = default;
+
+    [[nodiscard]] explicit Schema(
+        Object data, UnknownKeys unknown_keys = UnknownKeys::Collect) {
+        for (auto& [key, value] : data) {
+            auto index = index_of(key);
+
+            if (index != npos) {
+                m_slots[index] = std::move(value);
+            } else if (unknown_keys == UnknownKeys::Reject) {
+                throw UnknownKey{key};
+            } else {
+                m_unknown.insert({key, std::move(value)});
+            }
+        }
+    }
+
+    [[nodiscard]] explicit Schema(
+        Document document, UnknownKeys unknown_keys = UnknownKeys::Collect)
+    : Schema{std::move(document.data), unknown_keys} {}
+
+    // Returns npos if the key is not a part of the schema.
+    [[nodiscard]] static constexpr std::size_t
+    index_of(std::string_view key) noexcept {
+        auto index = hash.buckets[hash.bucket_of(key)];
+        return index != npos && keys[index] == key ? index : npos;
+    }
+
+    template <details::FixedString Key>
+    [[nodiscard]] const Value& get() const noexcept {
+        return m_slots[slot<Key>()];
+    }
+
+    template <details::FixedString Key> [[nodiscard]] Value& get() noexcept {
+        return m_slots[slot<Key>()];
+    }
+
+    [[nodiscard]] const Value& operator[](std::string_view key) const {
+        auto index = index_of(key);
+
+        if (index == npos) {
+            throw std::out_of_range{"key is not a part of the schema"};
+        }
+
+        return m_slots[index];
+    }
+
+    [[nodiscard]] Value& operator[](std::string_view key) {
+        return const_cast<Value&>(std::as_const(*this)[key]);
+    }
+
+    // Members whose keys are not a part of the schema.
+    [[nodiscard]] const Object& unknown() const noexcept { return m_unknown; }
+
+private:
+    template <details::FixedString Key>
+    [[nodiscard]] static consteval std::size_t slot() noexcept {
+        constexpr auto index = index_of(Key.view());
+        static_assert(index != npos, "key is not a part of the schema");
+
+        return index;
+    }
+
+    static constexpr details::PerfectHash<size> hash{keys};
+    static_assert(hash.seed < hash.max_seed);
+
+    std::array<Value, size> m_slots;
+    Object m_unknown;
+};
+
+} // namespace lumen
+
+#endif
@@ -0,0 +1,949 @@
+#ifndef LUMENCPP_STATIC_DOCUMENT_H
+#define LUMENCPP_STATIC_DOCUMENT_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "exceptions.h"
+#include "fixed_string.h"
+#include "position.h"
+#include "token.h"
+#include "utf8.h"
+#include "value.h"
+#include "value_view.h"
+
+namespace lumen {
+
+namespace details {
+
+// Reached only during constant evaluation, where throwing turns a malformed
+// document into a compile error that shows the description and position.
+constexpr void
+static_parse_error(const char* description, Position position) {
+    if (description != nullptr) {
+        throw ParseError{description, "<static>", {position, position}};
+    }
+}
+
+constexpr void static_parse_error(
+    const char* description, std::string_view key, Position position) {
+    if (description != nullptr) {
+        throw ParseError{
+            std::string{description} + " '" + std::string{key} + "'",
+            "<static>",
+            {position, position}};
+    }
+}
+
+struct StaticToken {
+    Token::Type type;
+    std::string lexeme;
+    Position position;
+};
+
+// Mirrors Lexer on top of constexpr-friendly character classification.
+class StaticLexer {
+public:
+    [[nodiscard]] constexpr std::vector<StaticToken>
+    lex(std::string_view source) {
+        std::vector<StaticToken> result;
+
+        m_at = source.begin();
+        m_end = source.end();
+        m_position = {};
+        m_can_parse_long_token = true;
+
+        skip_useless();
+
+        while (!at_end()) {
+            result.push_back(get_token());
+            skip_useless();
+        }
+
+        result.push_back({Token::Type::Eof, {}, m_position});
+
+        return result;
+    }
+
+private:
+    [[nodiscard]] static constexpr bool is_digit(char character) noexcept {
+        return character >= '0' && character <= '9';
+    }
+
+    [[nodiscard]] static constexpr bool
+    is_hex_digit(char character) noexcept {
+        return is_digit(character) || (character >= 'a' && character <= 'f') ||
+               (character >= 'A' && character <= 'F');
+    }
+
+    [[nodiscard]] static constexpr bool is_alpha(char character) noexcept {
+        return (character >= 'a' && character <= 'z') ||
+               (character >= 'A' && character <= 'Z');
+    }
+
+    [[nodiscard]] static constexpr bool is_space(char character) noexcept {
+        return character == ' ' || (character >= '\t' && character <= '\r');
+    }
+
+    [[nodiscard]] constexpr char at() const noexcept { return *m_at; }
+    [[nodiscard]] constexpr bool at_end() const noexcept {
+        return m_at == m_end;
+    }
+
+    constexpr char eat() noexcept {
+        if (at() == '\n') {
+            ++m_position.line;
+            m_position.column = 1;
+        } else {
+            ++m_position.column;
+        }
+
+        ++m_position.offset;
+
+        return *(m_at++);
+    }
+
+    constexpr void skip_useless() noexcept {
+        auto skip_whitespaces = [this] {
+            while (!at_end() && is_space(at()) && at() != '\n') {
+                eat();
+                m_can_parse_long_token = true;
+            }
+        };
+
+        skip_whitespaces();
+
+        while (!at_end() && at() == '#') {
+            while (!at_end() && at() != '\n') {
+                eat();
+            }
+
+            skip_whitespaces();
+        }
+    }
+
+    constexpr std::string get_integer(auto is_digit) {
+        std::string result;
+
+        while (!at_end() && (is_digit(at()) || at() == '_')) {
+            if (at() == '_') {
+                eat();
+                continue;
+            }
+
+            result += eat();
+        }
+
+        if (result.empty()) {
+            static_parse_error("expected a digit", m_position);
+        }
+
+        return result;
+    }
+
+    constexpr std::string get_integer() { return get_integer(is_digit); }
+
+    constexpr StaticToken get_identifier() {
+        StaticToken result{Token::Type::Identifier, {}, m_position};
+
+        while (!at_end() &&
+               (is_alpha(at()) || is_digit(at()) || at() == '-' ||
+                at() == '_')) {
+            result.lexeme += eat();
+        }
+
+        m_can_parse_long_token = false;
+
+        if (result.lexeme == "true" || result.lexeme == "false") {
+            result.type = Token::Type::Boolean;
+        }
+
+        return result;
+    }
+
+    constexpr StaticToken get_number() {
+        StaticToken result{Token::Type::Integer, {}, m_position};
+        auto& lexeme = result.lexeme;
+
+        auto get_if_e = [&] {
+            if (at_end() || at() != 'e') {
+                return false;
+            }
+
+            lexeme += eat();
+
+            if (!at_end() && (at() == '-' || at() == '+')) {
+                lexeme += eat();
+            }
+
+            lexeme += get_integer();
+
+            return true;
+        };
+
+        m_can_parse_long_token = false;
+
+        if (at() == '0') {
+            lexeme += eat();
+
+            if (at_end()) {
+                return result;
+            }
+
+            if (is_digit(at()) || at() == '_') {
+                static_parse_error("leading zeros are not allowed", m_position);
+            }
+
+            switch (at()) {
+            case 'x':
+                lexeme += eat();
+                lexeme += get_integer(is_hex_digit);
+
+                return result;
+            case 'o':
+                lexeme += eat();
+                lexeme += get_integer([](char character) {
+                    return character >= '0' && character <= '7';
+                });
+
+                return result;
+            case 'b':
+                lexeme += eat();
+                lexeme += get_integer([](char character) {
+                    return character == '0' || character == '1';
+                });
+
+                return result;
+            case '.':
+                lexeme += eat();
+                lexeme += get_integer();
+
+                get_if_e();
+                result.type = Token::Type::Float;
+
+                return result;
+            default:
+                return result;
+            }
+        }
+
+        if (at() == '+') {
+            eat();
+        } else if (at() == '-') {
+            lexeme += eat();
+        }
+
+        lexeme += get_integer();
+
+        if (!at_end() && at() == '.') {
+            lexeme += eat();
+            lexeme += get_integer();
+
+            get_if_e();
+            result.type = Token::Type::Float;
+        } else if (get_if_e()) {
+            result.type = Token::Type::Float;
+        }
+
+        return result;
+    }
+
+    constexpr StaticToken get_string() {
+        char quote = eat();
+        StaticToken result{Token::Type::String, {}, m_position};
+
+        while (true) {
+            if (at_end()) {
+                static_parse_error("unterminated string", result.position);
+            }
+
+            if (at() == quote) {
+                eat();
+                break;
+            }
+
+            if (at() == '\\') {
+                eat();
+
+                if (at_end()) {
+                    static_parse_error("unterminated string", result.position);
+                }
+
+                get_escape(result.lexeme);
+            } else {
+                get_utf8_sequence(result.lexeme);
+            }
+        }
+
+        m_can_parse_long_token = false;
+
+        return result;
+    }
+
+    constexpr void get_escape(std::string& lexeme) {
+        auto position = m_position;
+
+        switch (at()) {
+        case 'n':
+            lexeme += '\n';
+            break;
+        case 'r':
+            lexeme += '\r';
+            break;
+        case 't':
+            lexeme += '\t';
+            break;
+        case 'u':
+        case 'U': {
+            auto digits = eat() == 'u' ? 4 : 8;
+            std::uint32_t code_point = 0;
+
+            for (; digits > 0; --digits) {
+                if (at_end() || !is_hex_digit(at())) {
+                    static_parse_error(
+                        "invalid unicode escape sequence", position);
+                }
+
+                auto digit = eat();
+                code_point = code_point * 16 +
+                             static_cast<std::uint32_t>(
+                                 digit <= '9' ? digit - '0'
+                                              : (digit | 0x20) - 'a' + 10);
+            }
+
+            if (!utf8::is_scalar_value(code_point)) {
+                static_parse_error(
+                    "escaped code point is not a unicode scalar value",
+                    position);
+            }
+
+            utf8::append(lexeme, code_point);
+            return;
+        }
+        default:
+            get_utf8_sequence(lexeme);
+            return;
+        }
+
+        eat();
+    }
+
+    constexpr void get_utf8_sequence(std::string& lexeme) {
+        auto position = m_position;
+        auto length = utf8::sequence_length(at());
+        auto [low, high] = utf8::second_byte_range(at());
+
+        if (length == 0) {
+            static_parse_error("invalid UTF-8", position);
+        }
+
+        lexeme += eat();
+
+        for (std::size_t i = 1; i < length; ++i) {
+            if (at_end() || static_cast<unsigned char>(at()) < low ||
+                static_cast<unsigned char>(at()) > high) {
+                static_parse_error("invalid UTF-8", position);
+            }
+
+            lexeme += eat();
+
+            low = 0x80;
+            high = 0xbf;
+        }
+    }
+
+    constexpr StaticToken get_token() {
+        if (m_can_parse_long_token) {
+            if (is_alpha(at()) || at() == '_') {
+                return get_identifier();
+            }
+
+            if (is_digit(at()) || at() == '+' || at() == '-') {
+                return get_number();
+            }
+
+            if (at() == '"' || at() == '\'') {
+                return get_string();
+            }
+
+            if (at() == '`') {
+                auto token = get_string();
+                token.type = Token::Type::Identifier;
+
+                return token;
+            }
+        }
+
+        StaticToken result{Token::Type::Eof, {}, m_position};
+
+        switch (eat()) {
+        case '=':
+            result.type = Token::Type::Equal;
+            break;
+        case ';':
+            result.type = Token::Type::Semicolon;
+            break;
+        case ',':
+            result.type = Token::Type::Comma;
+            break;
+        case '.':
+            result.type = Token::Type::Dot;
+            break;
+        case '[':
+            result.type = Token::Type::LeftBracket;
+            break;
+        case ']':
+            result.type = Token::Type::RightBracket;
+            break;
+        case '{':
+            result.type = Token::Type::LeftBrace;
+            break;
+        case '}':
+            result.type = Token::Type::RightBrace;
+            break;
+        case '\n':
+            if (!at_end() && at() == '\r') {
+                eat();
+            }
+
+            result.type = Token::Type::LineBreak;
+            break;
+        default:
+            static_parse_error("unexpected character", result.position);
+        }
+
+        m_can_parse_long_token = true;
+
+        return result;
+    }
+
+    std::string_view::iterator m_at{};
+    std::string_view::iterator m_end{};
+
+    Position m_position{};
+
+    bool m_can_parse_long_token = true;
+};
+
+struct StaticNode {
+    [[nodiscard]] constexpr StaticNode() noexcept = default;
+
+    [[nodiscard]] constexpr explicit StaticNode(
+        Value::Type type, std::uint64_t payload = 0,
+        std::string_view string = {})
+    : type{type}, payload{payload}, string{string} {}
+
+    Value::Type type = Value::Type::Undefined;
+    std::uint64_t payload = 0;
+
+    std::string string;
+
+    std::vector<std::string> keys;
+    std::vector<StaticNode> children;
+};
+
+// Mirrors Parser, building a transient tree that is flattened afterwards.
+class StaticParser {
+public:
+    [[nodiscard]] constexpr StaticNode parse(std::string_view source) {
+        auto tokens = StaticLexer{}.lex(source);
+
+        m_data = StaticNode{Value::Type::Object};
+        m_at = tokens.begin();
+
+        skip_line_breaks();
+
+        while (!at_end()) {
+            if (at().type == Token::Type::Semicolon) {
+                eat();
+                skip_line_breaks();
+
+                continue;
+            }
+
+            parse_assignment(m_data);
+
+            if (at_end()) {
+                break;
+            }
+
+            expect(
+                Token::Type::LineBreak, Token::Type::Semicolon,
+                Token::Type::Eof);
+
+            skip_line_breaks();
+        }
+
+        return std::move(m_data);
+    }
+
+private:
+    [[nodiscard]] constexpr const StaticToken& at() const noexcept {
+        return *m_at;
+    }
+
+    [[nodiscard]] constexpr bool at_end() const noexcept {
+        return at().type == Token::Type::Eof;
+    }
+
+    constexpr const StaticToken& eat() noexcept { return *(m_at++); }
+
+    constexpr const StaticToken& expect(auto... expected) {
+        const auto& result = eat();
+
+        if (((result.type != expected) && ...)) {
+            static_parse_error("unexpected token", result.position);
+        }
+
+        return result;
+    }
+
+    constexpr void skip_line_breaks() noexcept {
+        while (!at_end() && at().type == Token::Type::LineBreak) {
+            eat();
+        }
+    }
+
+    [[nodiscard]] static constexpr StaticNode*
+    find(StaticNode& parent, std::string_view key) noexcept {
+        for (std::size_t i = 0; i < parent.keys.size(); ++i) {
+            if (parent.keys[i] == key) {
+                return &parent.children[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    constexpr StaticNode& parse_key_path(
+        StaticNode& parent, const StaticToken& token,
+        bool create_if_not_exist = true) {
+        auto* result = find(parent, token.lexeme);
+
+        if (result == nullptr ||
+            result->type == Value::Type::Undefined) {
+            if (!create_if_not_exist) {
+                static_parse_error(
+                    "field does not exist", token.lexeme, token.position);
+            }
+
+            if (result == nullptr) {
+                parent.keys.push_back(token.lexeme);
+                result = &parent.children.emplace_back();
+            }
+        }
+
+        if (at().type == Token::Type::Dot) {
+            eat();
+
+            if (result->type == Value::Type::Undefined) {
+                result->type = Value::Type::Object;
+            }
+
+            if (result->type != Value::Type::Object) {
+                static_parse_error(
+                    "unable to parse a key path, field is not an object",
+                    token.lexeme, token.position);
+            }
+
+            return parse_key_path(
+                *result, expect(Token::Type::Identifier), create_if_not_exist);
+        }
+
+        return *result;
+    }
+
+    [[nodiscard]] static constexpr UInt
+    to_unsigned(const StaticToken& token) {
+        std::string_view digits{token.lexeme};
+        UInt base = 10;
+
+        if (digits.starts_with("0x")) {
+            base = 16;
+        } else if (digits.starts_with("0o")) {
+            base = 8;
+        } else if (digits.starts_with("0b")) {
+            base = 2;
+        }
+
+        if (base != 10) {
+            digits.remove_prefix(2);
+        }
+
+        UInt result = 0;
+
+        for (auto character : digits) {
+            UInt digit = character <= '9' ? character - '0'
+                                          : (character | 0x20) - 'a' + 10;
+
+            if (result > (std::numeric_limits<UInt>::max() - digit) / base) {
+                static_parse_error(
+                    "integer is out of range", token.lexeme, token.position);
+            }
+
+            result = result * base + digit;
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] static constexpr StaticNode
+    parse_integer(const StaticToken& token) {
+        if (!token.lexeme.starts_with('-')) {
+            return StaticNode{Value::Type::UInt, to_unsigned(token)};
+        }
+
+        auto magnitude =
+            to_unsigned({token.type, token.lexeme.substr(1), token.position});
+
+        constexpr auto limit =
+            static_cast<UInt>(std::numeric_limits<Int>::max()) + 1;
+
+        if (magnitude > limit) {
+            static_parse_error(
+                "integer is out of range", token.lexeme, token.position);
+        }
+
+        return StaticNode{Value::Type::Int, 0 - magnitude};
+    }
+
+    // Exact whenever the significand fits into a double and the decimal
+    // exponent is within the range of exactly representable powers of ten;
+    // otherwise the result may differ from the runtime parser in the last
+    // bit.
+    [[nodiscard]] static constexpr StaticNode
+    parse_float(const StaticToken& token) {
+        std::string_view lexeme{token.lexeme};
+
+        bool is_negative = lexeme.starts_with('-');
+        UInt significand = 0;
+        int exponent = 0;
+        int significant_digits = 0;
+        bool is_fraction = false;
+
+        std::size_t at = is_negative ? 1 : 0;
+
+        for (; at < lexeme.size() && lexeme[at] != 'e'; ++at) {
+            if (lexeme[at] == '.') {
+                is_fraction = true;
+                continue;
+            }
+
+            constexpr auto max_significant_digits = 19;
+
+            if (significant_digits < max_significant_digits) {
+                significand = significand * 10 + (lexeme[at] - '0');
+                significant_digits += significand != 0 ? 1 : 0;
+                exponent -= is_fraction ? 1 : 0;
+            } else {
+                exponent += is_fraction ? 0 : 1;
+            }
+        }
+
+        if (at < lexeme.size()) {
+            ++at;
+
+            bool is_exponent_negative = lexeme[at] == '-';
+            at += lexeme[at] == '-' || lexeme[at] == '+' ? 1 : 0;
+
+            int written_exponent = 0;
+
+            for (; at < lexeme.size(); ++at) {
+                constexpr auto max_exponent = 100000;
+                written_exponent = std::min(
+                    written_exponent * 10 + (lexeme[at] - '0'), max_exponent);
+            }
+
+            exponent +=
+                is_exponent_negative ? -written_exponent : written_exponent;
+        }
+
+        constexpr auto max_exact_significand = UInt{1} << 53;
+        constexpr auto max_exact_exponent = 22;
+
+        Float result = 0;
+
+        if (significand <= max_exact_significand &&
+            exponent >= -max_exact_exponent && exponent <= max_exact_exponent) {
+            Float scale = 1;
+
+            for (int i = 0; i < (exponent < 0 ? -exponent : exponent); ++i) {
+                scale *= 10;
+            }
+
+            result = exponent < 0 ? static_cast<Float>(significand) / scale
+                                  : static_cast<Float>(significand) * scale;
+        } else {
+            auto scaled = static_cast<long double>(significand);
+
+            for (; exponent > 0 && scaled <= std::numeric_limits<Float>::max();
+                 --exponent) {
+                scaled *= 10;
+            }
+
+            for (; exponent < 0 && scaled != 0; ++exponent) {
+                scaled /= 10;
+            }
+
+            if (scaled > std::numeric_limits<Float>::max() ||
+                (significand != 0 &&
+                 scaled < std::numeric_limits<Float>::denorm_min())) {
+                static_parse_error(
+                    "float is out of range", token.lexeme, token.position);
+            }
+
+            result = static_cast<Float>(scaled);
+        }
+
+        return StaticNode{
+            Value::Type::Float,
+            std::bit_cast<UInt>(is_negative ? -result : result)};
+    }
+
+    constexpr StaticNode parse_array() {
+        StaticNode result{Value::Type::Array};
+
+        while (true) {
+            skip_line_breaks();
+
+            if (at_end()) {
+                expect(Token::Type::RightBracket);
+            }
+
+            if (at().type == Token::Type::RightBracket) {
+                break;
+            }
+
+            result.children.push_back(parse_value());
+
+            if (at().type == Token::Type::RightBracket) {
+                break;
+            }
+
+            expect(Token::Type::LineBreak, Token::Type::Comma);
+        }
+
+        eat();
+
+        return result;
+    }
+
+    constexpr StaticNode parse_object() {
+        StaticNode result{Value::Type::Object};
+
+        while (true) {
+            skip_line_breaks();
+
+            if (at_end()) {
+                expect(Token::Type::RightBrace);
+            }
+
+            if (at().type == Token::Type::RightBrace) {
+                break;
+            }
+
+            parse_assignment(result);
+
+            if (at().type == Token::Type::RightBrace) {
+                break;
+            }
+
+            expect(Token::Type::LineBreak, Token::Type::Comma);
+        }
+
+        eat();
+
+        return result;
+    }
+
+    constexpr StaticNode parse_value() {
+        const auto& token = expect(
+            Token::Type::LeftBracket, Token::Type::LeftBrace,
+            Token::Type::Identifier, Token::Type::Integer,
+            Token::Type::Boolean, Token::Type::Float, Token::Type::String);
+
+        switch (token.type) {
+        case Token::Type::LeftBracket:
+            return parse_array();
+        case Token::Type::LeftBrace:
+            return parse_object();
+        case Token::Type::Identifier:
+            return parse_key_path(m_data, token, false);
+        case Token::Type::Integer:
+            return parse_integer(token);
+        case Token::Type::Boolean:
+            return StaticNode{
+                Value::Type::Bool, token.lexeme == "true" ? 1U : 0U};
+        case Token::Type::Float:
+            return parse_float(token);
+        default:
+            return StaticNode{Value::Type::String, 0, token.lexeme};
+        }
+    }
+
+    constexpr void parse_assignment(StaticNode& parent) {
+        auto& key = parse_key_path(parent, expect(Token::Type::Identifier));
+        expect(Token::Type::Equal);
+
+        // Values never insert into existing objects, so the reference to the
+        // key stays valid.
+        key = parse_value();
+    }
+
+    StaticNode m_data;
+
+    std::vector<StaticToken>::const_iterator m_at;
+};
+
+struct StaticSizes {
+    std::size_t nodes = 1;
+    std::size_t strings = 0;
+};
+
+[[nodiscard]] constexpr StaticSizes measure(const StaticNode& node) noexcept {
+    StaticSizes result{1, node.string.size()};
+
+    for (const auto& key : node.keys) {
+        result.strings += key.size();
+    }
+
+    for (const auto& child : node.children) {
+        auto sizes = measure(child);
+
+        result.nodes += sizes.nodes;
+        result.strings += sizes.strings;
+    }
+
+    return result;
+}
+
+class StaticFlattener {
+public:
+    [[nodiscard]] constexpr StaticFlattener(
+        std::span<FlatNode> nodes, std::span<char> strings) noexcept
+    : m_nodes{nodes}, m_strings{strings} {}
+
+    constexpr void flatten(const StaticNode& root) {
+        m_node_count = 1;
+        m_string_size = 0;
+
+        write(root, 0);
+    }
+
+private:
+    constexpr std::uint32_t add_string(std::string_view string) {
+        auto offset = m_string_size;
+
+        std::copy(string.begin(), string.end(), m_strings.begin() + offset);
+        m_string_size += string.size();
+
+        return static_cast<std::uint32_t>(offset);
+    }
+
+    constexpr void write(const StaticNode& node, std::size_t index) {
+        auto& flat = m_nodes[index];
+
+        flat.type = node.type;
+        flat.payload = node.payload;
+
+        if (node.type == Value::Type::String) {
+            flat.payload = add_string(node.string);
+            flat.size = static_cast<std::uint32_t>(node.string.size());
+        }
+
+        if (node.type != Value::Type::Array &&
+            node.type != Value::Type::Object) {
+            return;
+        }
+
+        auto first = m_node_count;
+        m_node_count += node.children.size();
+
+        flat.payload = first;
+        flat.size = static_cast<std::uint32_t>(node.children.size());
+
+        std::vector<std::size_t> order(node.children.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+
+        if (node.type == Value::Type::Object) {
+            std::sort(order.begin(), order.end(), [&node](auto lhs, auto rhs) {
+                return node.keys[lhs] < node.keys[rhs];
+            });
+        }
+
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            if (node.type == Value::Type::Object) {
+                const auto& key = node.keys[order[i]];
+
+                m_nodes[first + i].key_offset = add_string(key);
+                m_nodes[first + i].key_size =
+                    static_cast<std::uint32_t>(key.size());
+            }
+
+            write(node.children[order[i]], first + i);
+        }
+    }
+
+    std::span<FlatNode> m_nodes;
+    std::span<char> m_strings;
+
+    std::size_t m_node_count = 0;
+    std::size_t m_string_size = 0;
+};
+
+} // namespace details
+
+template <std::size_t NodeCount, std::size_t StringSize>
+struct StaticDocument {
+    [[nodiscard]] constexpr ValueView root() const noexcept {
+        return {nodes, {strings.data(), strings.size()}};
+    }
+
+    [[nodiscard]] constexpr auto begin() const noexcept {
+        return root().begin();
+    }
+
+    [[nodiscard]] constexpr auto end() const noexcept { return root().end(); }
+
+    [[nodiscard]] constexpr bool contains(std::string_view key) const {
+        return root().contains(key);
+    }
+
+    [[nodiscard]] constexpr auto at(std::string_view key) const {
+        return root()[key];
+    }
+
+    [[nodiscard]] constexpr auto operator[](std::string_view key) const {
+        return root()[key];
+    }
+
+    std::array<details::FlatNode, NodeCount> nodes{};
+    std::array<char, StringSize> strings{};
+};
+
+// Parses a document during compilation; a malformed document is a compile
+// error.
+template <details::FixedString Source>
+[[nodiscard]] consteval auto parse_static() {
+    constexpr auto sizes =
+        details::measure(details::StaticParser{}.parse(Source.view()));
+
+    StaticDocument<sizes.nodes, sizes.strings> result;
+    details::StaticFlattener{result.nodes, result.strings}.flatten(
+        details::StaticParser{}.parse(Source.view()));
+
+    return result;
+}
+
+} // namespace lumen
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef LUMENCPP_STRING_POOL_H
+#define LUMENCPP_STRING_POOL_H
+
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+
+#include "value.h"
+
+namespace lumen {
+
+// Hands out one shared, immutable copy of every distinct string. Values built
+// from the pool hold a reference to the copy, so the pool may be cleared or
+// destroyed while they are alive. Not synchronized: use one pool per thread or
+// guard it externally.
+class StringPool {
+public:
+    struct Stats {
+        // Strings passed to intern().
+        std::size_t strings = 0;
+
+        // Strings that were already in the pool.
+        std::size_t deduplicated = 0;
+
+        // Bytes of the copies that deduplication avoided.
+        std::size_t bytes_saved = 0;
+    };
+
+    [[nodiscard]] SharedString intern(String string);
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_strings.size(); }
+
+    [[nodiscard]] const Stats& stats() const noexcept { return m_stats; }
+
+    // Forgets the pooled strings but keeps the stats.
+    void clear() noexcept { m_strings.clear(); }
+
+private:
+    // Keys view the pooled strings, which never move.
+    std::unordered_map<std::string_view, SharedString> m_strings;
+
+    Stats m_stats;
+};
+
+} // namespace lumen
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef LUMENCPP_SWAR_H
+#define LUMENCPP_SWAR_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace lumen::details::swar {
+
+inline constexpr bool enabled = std::endian::native == std::endian::little;
+
+inline constexpr std::uint64_t ones = 0x0101010101010101;
+inline constexpr std::uint64_t high_bits = ones * 0x80;
+
+// Only used where `enabled`, so the bytes are assembled in little-endian
+// order during constant evaluation, where memcpy is not available.
+[[nodiscard]] constexpr std::uint64_t load(const char* bytes) noexcept {
+    std::uint64_t result = 0;
+
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < sizeof(result); ++i) {
+            result |= std::uint64_t{static_cast<unsigned char>(bytes[i])}
+                      << (8 * i);
+        }
+    } else {
+        std::memcpy(&result, bytes, sizeof(result));
+    }
+
+    return result;
+}
+
+// Sets the high bit of every byte that lies strictly between `low` and
+// `high`; bytes with the high bit set never match.
+[[nodiscard]] constexpr std::uint64_t
+between(std::uint64_t chunk, std::uint8_t low, std::uint8_t high) noexcept {
+    constexpr auto low_bits = ones * 0x7f;
+
+    auto masked = chunk & low_bits;
+
+    return (ones * (0x7f + high) - masked) & ~chunk &
+           (masked + ones * (0x7f - low)) & high_bits;
+}
+
+// Sets the high bit of bytes below `bound`, which must not exceed 0x80. Only
+// the lowest flagged byte is exact: a borrow may flag bytes above it.
+[[nodiscard]] constexpr std::uint64_t
+less(std::uint64_t chunk, std::uint8_t bound) noexcept {
+    return (chunk - ones * bound) & ~chunk & high_bits;
+}
+
+// Sets the high bit of bytes equal to `byte`, with the same caveat as `less`.
+[[nodiscard]] constexpr std::uint64_t
+equal(std::uint64_t chunk, std::uint8_t byte) noexcept {
+    return less(chunk ^ (ones * byte), 1);
+}
+
+template <unsigned Base>
+[[nodiscard]] constexpr bool is_digit(char character) noexcept {
+    if constexpr (Base == 16) {
+        return (character >= '0' && character <= '9') ||
+               (character >= 'a' && character <= 'f') ||
+               (character >= 'A' && character <= 'F');
+    } else {
+        return character >= '0' &&
+               character < static_cast<char>('0' + Base);
+    }
+}
+
+template <unsigned Base>
+[[nodiscard]] constexpr std::uint64_t digit_mask(std::uint64_t chunk) noexcept {
+    if constexpr (Base == 16) {
+        return between(chunk, '0' - 1, '9' + 1) |
+               between(chunk, 'a' - 1, 'f' + 1) |
+               between(chunk, 'A' - 1, 'F' + 1);
+    } else {
+        return between(chunk, '0' - 1, '0' + Base);
+    }
+}
+
+// Counts the digits at the beginning of eight bytes.
+template <unsigned Base>
+[[nodiscard]] constexpr std::size_t count_digits(const char* bytes) noexcept {
+    auto non_digits = ~digit_mask<Base>(load(bytes)) & high_bits;
+    return static_cast<std::size_t>(std::countr_zero(non_digits)) / 8;
+}
+
+// Converts eight decimal digits with three multiplications instead of eight.
+[[nodiscard]] constexpr std::uint64_t
+parse_eight_digits(const char* bytes) noexcept {
+    auto chunk = load(bytes) - ones * '0';
+
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000ff000000ff) * (100 + (1000000ULL << 32))) +
+             (((chunk >> 16) & 0x000000ff000000ff) * (1 + (10000ULL << 32)))) >>
+            32;
+
+    return chunk;
+}
+
+// Returns nothing if the value does not fit.
+template <unsigned Base>
+[[nodiscard]] constexpr std::optional<std::uint64_t>
+parse_unsigned(std::string_view digits) noexcept {
+    digits.remove_prefix(
+        std::min(digits.find_first_not_of('0'), digits.size()));
+
+    std::uint64_t result = 0;
+
+    if constexpr (Base == 10) {
+        constexpr std::size_t max_digits = 20;
+
+        if (digits.size() > max_digits) {
+            return std::nullopt;
+        }
+
+        // Nineteen decimal digits always fit into 64 bits.
+        auto safe_digits = std::min(digits.size(), max_digits - 1);
+        std::size_t at = 0;
+
+        if constexpr (enabled) {
+            for (; safe_digits - at >= 8; at += 8) {
+                result = result * 100000000 + parse_eight_digits(&digits[at]);
+            }
+        }
+
+        for (; at < safe_digits; ++at) {
+            result = result * 10 + static_cast<std::uint64_t>(digits[at] - '0');
+        }
+
+        if (at < digits.size()) {
+            auto digit = static_cast<std::uint64_t>(digits[at] - '0');
+
+            if (result > (std::numeric_limits<std::uint64_t>::max() - digit) /
+                             10) {
+                return std::nullopt;
+            }
+
+            result = result * 10 + digit;
+        }
+    } else {
+        constexpr auto bits = std::countr_zero(Base);
+
+        for (auto character : digits) {
+            if ((result >> (64 - bits)) != 0) {
+                return std::nullopt;
+            }
+
+            auto digit = character <= '9' ? character - '0'
+                                          : (character | 0x20) - 'a' + 10;
+
+            result = (result << bits) | static_cast<std::uint64_t>(digit);
+        }
+    }
+
+    return result;
+}
+
+} // namespace lumen::details::swar
+
+#endif
@@ -4,7 +4,6 @@
 #include <cstdint>
 #include <optional>
 #include <string>
-#include <utility>
 
 #include "exceptions.h"
 
@@ -26,18 +25,18 @@ struct Token {
         Float,
         String,
         LineBreak,
+
+        // Input that the lexer reported an error for; only produced when
+        // recovering from errors.
+        Invalid,
+
         Eof
     };
 
-    [[nodiscard]] Token(
-        SourceRegion source, Type type,
-        std::optional<std::string> lexeme = std::nullopt)
-    : source{source}, type{type}, lexeme{std::move(lexeme)} {}
-
     SourceRegion source;
 
     Type type;
-    std::optional<std::string> lexeme;
+    std::optional<std::string> lexeme = std::nullopt;
 };
 
 } // namespace lumen
@@ -0,0 +1,81 @@
+#ifndef LUMENCPP_UTF8_H
+#define LUMENCPP_UTF8_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace lumen::details::utf8 {
+
+// Length of the sequence started by `lead`, or zero if no well-formed sequence
+// starts with it.
+[[nodiscard]] constexpr std::size_t sequence_length(char lead) noexcept {
+    auto byte = static_cast<unsigned char>(lead);
+
+    if (byte < 0x80) {
+        return 1;
+    }
+
+    if (byte < 0xc2) {
+        return 0;
+    }
+
+    if (byte < 0xe0) {
+        return 2;
+    }
+
+    if (byte < 0xf0) {
+        return 3;
+    }
+
+    return byte < 0xf5 ? 4 : 0;
+}
+
+// Bounds of the byte after `lead`; narrower than those of later continuation
+// bytes where that rules out overlong encodings, surrogates and code points
+// above U+10FFFF.
+[[nodiscard]] constexpr std::pair<unsigned char, unsigned char>
+second_byte_range(char lead) noexcept {
+    switch (static_cast<unsigned char>(lead)) {
+    case 0xe0:
+        return {0xa0, 0xbf};
+    case 0xed:
+        return {0x80, 0x9f};
+    case 0xf0:
+        return {0x90, 0xbf};
+    case 0xf4:
+        return {0x80, 0x8f};
+    default:
+        return {0x80, 0xbf};
+    }
+}
+
+[[nodiscard]] constexpr bool
+is_scalar_value(std::uint32_t code_point) noexcept {
+    return code_point < 0xd800 ||
+           (code_point >= 0xe000 && code_point <= 0x10ffff);
+}
+
+// Appends the encoding of a scalar value.
+template <typename String>
+constexpr void append(String& output, std::uint32_t code_point) {
+    if (code_point < 0x80) {
+        output += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        output += static_cast<char>(0xc0 | (code_point >> 6));
+        output += static_cast<char>(0x80 | (code_point & 0x3f));
+    } else if (code_point < 0x10000) {
+        output += static_cast<char>(0xe0 | (code_point >> 12));
+        output += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        output += static_cast<char>(0x80 | (code_point & 0x3f));
+    } else {
+        output += static_cast<char>(0xf0 | (code_point >> 18));
+        output += static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+        output += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        output += static_cast<char>(0x80 | (code_point & 0x3f));
+    }
+}
+
+} // namespace lumen::details::utf8
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef LUMENCPP_VALIDATOR_H
+#define LUMENCPP_VALIDATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "document.h"
+#include "frozen_document.h"
+#include "mapped_document.h"
+#include "schema.h"
+#include "value.h"
+#include "value_view.h"
+
+namespace lumen {
+
+struct Violation {
+    enum struct Kind : std::uint8_t { Missing, Type, Range, UnknownKey };
+
+    Kind kind;
+
+    // Keys joined by dots, with array elements as [index]; empty for the
+    // root.
+    std::string path;
+
+    std::string description;
+};
+
+namespace details {
+
+// One entry of a compiled schema; entries refer to each other by index.
+struct Check {
+    static constexpr std::uint32_t none = 0xffffffff;
+
+    // Bit (1 << type) for every allowed Value::Type.
+    std::uint16_t types = 0;
+
+    bool has_min = false;
+    bool has_max = false;
+    bool reject_unknown_keys = false;
+
+    Float min = 0;
+    Float max = 0;
+
+    // Check for the elements of an array.
+    std::uint32_t items = none;
+
+    // Range of the fields of an object, sorted by key.
+    std::uint32_t fields_begin = 0;
+    std::uint32_t fields_end = 0;
+};
+
+struct FieldCheck {
+    std::string key;
+    std::uint32_t check = Check::none;
+    bool is_required = false;
+};
+
+} // namespace details
+
+// A schema compiled once into a flat table of checks, which validates
+// documents without throwing and reports every violation with its path.
+// The schema is itself a Lumen document that describes the top-level keys:
+//
+//     host = {type = "string", required = true}
+//     port = {type = "integer", min = 1, max = 65535}
+//     tags = {type = "array", items = "string", max = 16}
+//     limits = {
+//         type = "object"
+//         unknown_keys = "reject"
+//         fields = {rate = "number", burst = {type = "integer", min = 0}}
+//     }
+//
+// A type is "any", "integer", "float", "number", "bool", "string", "array",
+// "object" or an array of these; a bare type stands for {type = ...}. The
+// bounds min and max apply to numbers, to the length of strings and to the
+// number of elements or members of arrays and objects.
+class Validator {
+public:
+    // Accepts any object.
+    [[nodiscard]] Validator();
+
+    // Throws a SchemaError if the schema is malformed. UnknownKeys::Reject
+    // reports top-level keys that the schema does not describe.
+    [[nodiscard]] explicit Validator(
+        const Object& schema,
+        UnknownKeys unknown_keys = UnknownKeys::Collect);
+
+    [[nodiscard]] explicit Validator(
+        const Document& schema,
+        UnknownKeys unknown_keys = UnknownKeys::Collect)
+    : Validator{schema.data, unknown_keys} {}
+
+    // Append the violations found and return whether there were none.
+    bool validate(const Value& value, std::vector<Violation>& violations) const;
+    bool
+    validate(const Object& object, std::vector<Violation>& violations) const;
+    bool validate(ValueView value, std::vector<Violation>& violations) const;
+
+    bool validate(
+        const Document& document, std::vector<Violation>& violations) const {
+        return validate(document.data, violations);
+    }
+
+    bool validate(
+        const FrozenDocument& document,
+        std::vector<Violation>& violations) const {
+        return validate(document.root(), violations);
+    }
+
+    bool validate(
+        const MappedDocument& document,
+        std::vector<Violation>& violations) const {
+        return validate(document.root(), violations);
+    }
+
+    // Stops at the first violation and builds no messages.
+    [[nodiscard]] bool is_valid(const Value& value) const;
+    [[nodiscard]] bool is_valid(const Object& object) const;
+    [[nodiscard]] bool is_valid(ValueView value) const;
+
+    [[nodiscard]] bool is_valid(const Document& document) const {
+        return is_valid(document.data);
+    }
+
+    [[nodiscard]] bool is_valid(const FrozenDocument& document) const {
+        return is_valid(document.root());
+    }
+
+    [[nodiscard]] bool is_valid(const MappedDocument& document) const {
+        return is_valid(document.root());
+    }
+
+private:
+    // The first check is the one for the root.
+    std::vector<details::Check> m_checks;
+    std::vector<details::FieldCheck> m_fields;
+};
+
+} // namespace lumen
+
+#endif
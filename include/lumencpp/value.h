@@ -1,10 +1,15 @@
 #ifndef LUMENCPP_VALUE_H
 #define LUMENCPP_VALUE_H
 
+#include <algorithm>
+#include <atomic>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <initializer_list>
 #include <map>
+#include <memory>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -26,10 +31,218 @@ using String = std::string;
 using Array = std::vector<Value>;
 using Object = std::unordered_map<std::string, Value>;
 
+// An immutable string shared between values, e.g. by a StringPool. Reported
+// and retrieved as a String; modifying it makes the value its own copy.
+using SharedString = std::shared_ptr<const String>;
+
 namespace details {
 
-using ValueType =
-    std::variant<std::monostate, UInt, Int, Float, Bool, String, Array, Object>;
+template <typename Element> class PackedStorage {
+public:
+    [[nodiscard]] PackedStorage() = default;
+
+    [[nodiscard]] PackedStorage(const PackedStorage& other)
+    : m_elements{std::make_unique_for_overwrite<Element[]>(other.m_size)},
+      m_size{other.m_size}, m_capacity{other.m_size} {
+        std::copy_n(other.m_elements.get(), m_size, m_elements.get());
+    }
+
+    [[nodiscard]] PackedStorage(PackedStorage&& other) noexcept
+    : m_elements{std::move(other.m_elements)},
+      m_size{std::exchange(other.m_size, 0)},
+      m_capacity{std::exchange(other.m_capacity, 0)} {}
+
+    ~PackedStorage() = default;
+
+    PackedStorage& operator=(const PackedStorage& other) {
+        return *this = PackedStorage{other};
+    }
+
+    PackedStorage& operator=(PackedStorage&& other) noexcept {
+        m_elements = std::move(other.m_elements);
+        m_size = std::exchange(other.m_size, 0);
+        m_capacity = std::exchange(other.m_capacity, 0);
+
+        return *this;
+    }
+
+    [[nodiscard]] auto size() const noexcept { return m_size; }
+    [[nodiscard]] auto capacity() const noexcept { return m_capacity; }
+
+    [[nodiscard]] std::span<const Element> elements() const noexcept {
+        return {m_elements.get(), m_size};
+    }
+
+    void push_back(Element element) {
+        if (m_size == m_capacity) {
+            reallocate(m_capacity == 0 ? 8 : m_capacity * 2);
+        }
+
+        m_elements[m_size++] = element;
+    }
+
+    void shrink_to_fit() {
+        if (m_size != m_capacity) {
+            reallocate(m_size);
+        }
+    }
+
+    [[nodiscard]] bool operator==(const PackedStorage& other) const noexcept {
+        return std::ranges::equal(elements(), other.elements());
+    }
+
+private:
+    void reallocate(std::size_t capacity) {
+        auto elements = std::make_unique_for_overwrite<Element[]>(capacity);
+        std::copy_n(m_elements.get(), m_size, elements.get());
+
+        m_elements = std::move(elements);
+        m_capacity = capacity;
+    }
+
+    std::unique_ptr<Element[]> m_elements;
+
+    std::size_t m_size = 0;
+    std::size_t m_capacity = 0;
+};
+
+} // namespace details
+
+class PackedArray {
+public:
+    using Storage = std::variant<
+        std::monostate, details::PackedStorage<UInt>,
+        details::PackedStorage<Int>, details::PackedStorage<Float>,
+        details::PackedStorage<Bool>>;
+
+    [[nodiscard]] PackedArray() = default;
+
+    [[nodiscard]] PackedArray(const PackedArray& other)
+    : m_storage{other.m_storage} {}
+
+    [[nodiscard]] PackedArray(PackedArray&& other) noexcept
+    : m_storage{std::move(other.m_storage)},
+      m_unpacked{other.m_unpacked.exchange(nullptr)} {}
+
+    ~PackedArray();
+
+    PackedArray& operator=(const PackedArray& other) {
+        return *this = PackedArray{other};
+    }
+
+    PackedArray& operator=(PackedArray&& other) noexcept;
+
+    template <typename Element>
+    [[nodiscard]] bool holds() const noexcept {
+        return std::holds_alternative<details::PackedStorage<Element>>(
+            m_storage);
+    }
+
+    template <typename Element>
+    [[nodiscard]] std::span<const Element> elements() const noexcept {
+        const auto* storage =
+            std::get_if<details::PackedStorage<Element>>(&m_storage);
+
+        return storage != nullptr ? storage->elements()
+                                  : std::span<const Element>{};
+    }
+
+    // Calls the visitor with an std::span over the elements.
+    template <typename Visitor>
+    decltype(auto) visit(Visitor&& visitor) const {
+        return std::visit(
+            [&visitor]<typename Storage>(const Storage& storage) {
+                if constexpr (std::is_same_v<Storage, std::monostate>) {
+                    return std::forward<Visitor>(visitor)(
+                        std::span<const UInt>{});
+                } else {
+                    return std::forward<Visitor>(visitor)(storage.elements());
+                }
+            },
+            m_storage);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return visit([](auto elements) { return elements.size(); });
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    // Appends a scalar of the same type as the other elements; leaves the
+    // array untouched and returns false otherwise.
+    bool push_back(const Value& value);
+
+    void clear() noexcept {
+        m_storage = std::monostate{};
+        drop_unpacked();
+    }
+
+    void shrink_to_fit() {
+        std::visit(
+            []<typename Storage>(Storage& storage) {
+                if constexpr (!std::is_same_v<Storage, std::monostate>) {
+                    storage.shrink_to_fit();
+                }
+            },
+            m_storage);
+    }
+
+    [[nodiscard]] Array unpack() const;
+
+    // Materialized once on first use and kept for the lifetime of the array,
+    // so that element references can be handed out from const accessors.
+    [[nodiscard]] const Array& unpacked() const;
+
+    [[nodiscard]] bool operator==(const PackedArray& other) const noexcept {
+        return (empty() && other.empty()) || m_storage == other.m_storage;
+    }
+
+private:
+    // Modifiers are never concurrent with readers, so the cheap check is safe.
+    void drop_unpacked() noexcept {
+        if (m_unpacked.load(std::memory_order_relaxed) != nullptr) {
+            delete m_unpacked.exchange(nullptr);
+        }
+    }
+
+    template <typename Element> bool push_back_as(Element element) {
+        if (std::holds_alternative<std::monostate>(m_storage)) {
+            m_storage.emplace<details::PackedStorage<Element>>();
+        }
+
+        auto* storage =
+            std::get_if<details::PackedStorage<Element>>(&m_storage);
+
+        if (storage == nullptr) {
+            return false;
+        }
+
+        storage->push_back(element);
+
+        return true;
+    }
+
+    Storage m_storage;
+    mutable std::atomic<Array*> m_unpacked = nullptr;
+};
+
+namespace details {
+
+using ValueType = std::variant<
+    std::monostate, UInt, Int, Float, Bool, String, Array, Object,
+    PackedArray, SharedString>;
+
+// Arrays and objects nested deeper than max_depth are destroyed after their
+// ancestors rather than from within them, so that destroying a deep tree does
+// not overflow the call stack.
+struct DestructionState {
+    static constexpr std::size_t max_depth = 256;
+
+    std::size_t depth = 0;
+    std::vector<ValueType>* deferred = nullptr;
+};
+
+inline thread_local DestructionState destruction_state;
 
 template <typename ValueType> struct IsStdVector : std::false_type {};
 
@@ -55,6 +268,14 @@ struct IsStdUnorderedMap<std::unordered_map<Args...>> : std::true_type {};
 template <typename ValueType>
 concept StdUnorderedMap = IsStdUnorderedMap<ValueType>::value;
 
+template <typename ValueType> struct IsStdSpan : std::false_type {};
+
+template <typename Element, std::size_t Extent>
+struct IsStdSpan<std::span<Element, Extent>> : std::true_type {};
+
+template <typename ValueType>
+concept StdSpan = IsStdSpan<ValueType>::value;
+
 template <typename ValueType, typename Variant>
 struct IsStdVariantMember : std::false_type {};
 
@@ -82,6 +303,14 @@ public:
 
     [[nodiscard]] Value() noexcept : m_value{std::monostate{}} {}
 
+    [[nodiscard]] Value(const Value&) = default;
+    [[nodiscard]] Value(Value&&) = default;
+
+    Value& operator=(const Value&) = default;
+    Value& operator=(Value&&) = default;
+
+    ~Value();
+
     [[nodiscard]] Value(std::unsigned_integral auto value) noexcept
     : m_value{static_cast<UInt>(value)} {}
 
@@ -114,16 +343,30 @@ public:
 
     [[nodiscard]] Value(Object value) noexcept : m_value{std::move(value)} {}
 
+    [[nodiscard]] Value(PackedArray value) noexcept
+    : m_value{std::move(value)} {}
+
+    [[nodiscard]] Value(SharedString value) noexcept
+    : m_value{std::move(value)} {}
+
     [[nodiscard]] Value(
         std::initializer_list<Object::value_type> value) noexcept
     : m_value{Object{value}} {}
 
     Value& operator=(auto value) noexcept {
-        *this = Value{value};
+        *this = Value{std::move(value)};
         return *this;
     }
 
     [[nodiscard]] auto get_type() const noexcept {
+        if (std::holds_alternative<PackedArray>(m_value)) {
+            return Type::Array;
+        }
+
+        if (std::holds_alternative<SharedString>(m_value)) {
+            return Type::String;
+        }
+
         return static_cast<Type>(m_value.index());
     }
 
@@ -132,6 +375,14 @@ public:
     }
 
     template <typename ValueType> [[nodiscard]] bool is() const noexcept {
+        if constexpr (std::is_same_v<ValueType, Array>) {
+            return std::holds_alternative<Array>(m_value) ||
+                   std::holds_alternative<PackedArray>(m_value);
+        } else if constexpr (std::is_same_v<ValueType, String>) {
+            return std::holds_alternative<String>(m_value) ||
+                   std::holds_alternative<SharedString>(m_value);
+        }
+
         return std::holds_alternative<ValueType>(m_value);
     }
 
@@ -141,6 +392,14 @@ public:
             m_value = ValueType{};
         }
 
+        if constexpr (std::is_same_v<ValueType, Array>) {
+            if (std::holds_alternative<PackedArray>(m_value)) {
+                m_value = get_impl<PackedArray>().unpack();
+            }
+        } else if constexpr (std::is_same_v<ValueType, String>) {
+            unshare();
+        }
+
         try {
             return std::get<ValueType>(m_value);
         } catch (...) {
@@ -155,6 +414,16 @@ public:
 
     template <details::StdVariantMember<details::ValueType> ValueType>
     [[nodiscard]] const auto& get_strict() const {
+        if constexpr (std::is_same_v<ValueType, Array>) {
+            if (std::holds_alternative<PackedArray>(m_value)) {
+                return get_impl<PackedArray>().unpacked();
+            }
+        } else if constexpr (std::is_same_v<ValueType, String>) {
+            if (std::holds_alternative<SharedString>(m_value)) {
+                return *get_impl<SharedString>();
+            }
+        }
+
         try {
             return std::get<ValueType>(m_value);
         } catch (...) {
@@ -169,17 +438,17 @@ public:
 
     template <std::integral Integral>
         requires(!std::is_same_v<Integral, Bool>)
-    [[nodiscard]] auto get() const {
+    [[nodiscard]] auto get() const& {
         return is<UInt>() ? static_cast<Integral>(get_impl<UInt>())
                           : static_cast<Integral>(get_strict<Int>());
     }
 
-    template <std::same_as<Bool>> [[nodiscard]] auto get() const {
+    template <std::same_as<Bool>> [[nodiscard]] auto get() const& {
         return get_strict<Bool>();
     }
 
     template <std::floating_point FloatingPoint>
-    [[nodiscard]] auto get() const {
+    [[nodiscard]] auto get() const& {
         if (is<UInt>()) {
             return static_cast<FloatingPoint>(get_impl<UInt>());
         }
@@ -195,35 +464,104 @@ public:
         requires(
             !std::is_same_v<StringLike, String> &&
             !std::is_same_v<StringLike, Bool>)
-    [[nodiscard]] auto get() const {
+    [[nodiscard]] auto get() const& {
         return StringLike{get_strict<String>().c_str()};
     }
 
-    template <std::same_as<String>> [[nodiscard]] const auto& get() const {
+    template <std::same_as<String>> [[nodiscard]] const auto& get() const& {
         return get_strict<String>();
     }
 
+    template <std::same_as<String>> [[nodiscard]] String get() && {
+        return std::move(get_movable<String>());
+    }
+
     template <details::StdVector Vector>
         requires(!std::is_same_v<Vector, Array>)
-    [[nodiscard]] auto get() const {
+    [[nodiscard]] auto get() const& {
+        using Element = typename Vector::value_type;
+
+        if (is<PackedArray>()) {
+            return get_impl<PackedArray>().visit([](auto elements) {
+                if constexpr (std::is_same_v<
+                                  typename decltype(elements)::value_type,
+                                  Element>) {
+                    return Vector(elements.begin(), elements.end());
+                } else {
+                    Vector result;
+                    result.reserve(elements.size());
+
+                    for (auto element : elements) {
+                        result.push_back(Value{element}.get<Element>());
+                    }
+
+                    return result;
+                }
+            });
+        }
+
         Vector result;
         result.reserve(get_strict<Array>().size());
 
         for (const auto& value : get_impl<Array>()) {
-            result.push_back(value.get<typename Vector::value_type>());
+            result.push_back(value.get<Element>());
         }
 
         return result;
     }
 
-    template <std::same_as<Array>> [[nodiscard]] const auto& get() const {
+    // Checks every element before moving any, so that on a type mismatch the
+    // array is left untouched.
+    template <details::StdVector Vector>
+        requires(!std::is_same_v<Vector, Array>)
+    [[nodiscard]] auto get() && {
+        if (is<PackedArray>() || !converts_to<Vector>()) {
+            return std::as_const(*this).template get<Vector>();
+        }
+
+        return std::move(*this).template convert<Vector>();
+    }
+
+    template <std::same_as<Array>> [[nodiscard]] const auto& get() const& {
         return get_strict<Array>();
     }
 
+    template <std::same_as<Array>> [[nodiscard]] Array get() && {
+        if (is<PackedArray>()) {
+            return get_impl<PackedArray>().unpack();
+        }
+
+        return std::move(get_movable<Array>());
+    }
+
+    // Views a packed array without copying; throws unless the array is packed
+    // with exactly the requested element type or is empty.
+    template <details::StdSpan Span>
+        requires(
+            std::is_const_v<typename Span::element_type> &&
+            Span::extent == std::dynamic_extent)
+    [[nodiscard]] Span get() const& {
+        using Element = typename Span::value_type;
+
+        if (is<PackedArray>()) {
+            const auto& packed = get_impl<PackedArray>();
+
+            if (packed.template holds<Element>()) {
+                return packed.template elements<Element>();
+            }
+        } else if (get_strict<Array>().empty()) {
+            return {};
+        }
+
+        throw TypeMismatch{
+            "attempted to view an array that is not packed with the requested "
+            "type"};
+    }
+
     template <details::StdMap Map>
         requires(
             std::is_constructible_v<typename Map::key_type, Object::key_type>)
-    [[nodiscard]] auto get() const {
+    [[nodiscard]] auto get() const& {
         Map result;
 
         for (const auto& [key, value] : get_strict<Object>()) {
@@ -239,7 +577,7 @@ public:
             std::is_constructible_v<
                 typename UnorderedMap::key_type, Object::key_type> &&
             !std::is_same_v<UnorderedMap, Object>)
-    [[nodiscard]] auto get() const {
+    [[nodiscard]] auto get() const& {
         UnorderedMap result;
         result.reserve(get_strict<Object>().size());
 
@@ -251,12 +589,29 @@ public:
         return result;
     }
 
-    template <std::same_as<Object>> [[nodiscard]] const auto& get() const {
+    template <typename Map>
+        requires(
+            (details::StdMap<Map> || details::StdUnorderedMap<Map>) &&
+            std::is_constructible_v<typename Map::key_type, Object::key_type> &&
+            !std::is_same_v<Map, Object>)
+    [[nodiscard]] auto get() && {
+        if (!converts_to<Map>()) {
+            return std::as_const(*this).template get<Map>();
+        }
+
+        return std::move(*this).template convert<Map>();
+    }
+
+    template <std::same_as<Object>> [[nodiscard]] const auto& get() const& {
         return get_strict<Object>();
     }
 
+    template <std::same_as<Object>> [[nodiscard]] Object get() && {
+        return std::move(get_movable<Object>());
+    }
+
     template <typename ValueType>
-    [[nodiscard]] auto get_or(ValueType value) const noexcept {
+    [[nodiscard]] auto get_or(ValueType value) const& noexcept {
         try {
             return get<ValueType>();
         } catch (...) {
@@ -264,6 +619,24 @@ public:
         }
     }
 
+    template <typename ValueType>
+    [[nodiscard]] auto get_or(ValueType value) && noexcept {
+        try {
+            return std::move(*this).template get<ValueType>();
+        } catch (...) {
+            return value;
+        }
+    }
+
+    // Moves the value out and leaves this one undefined; on a type mismatch
+    // the value is left untouched.
+    template <typename ValueType> [[nodiscard]] auto take() {
+        auto result = std::move(*this).template get<ValueType>();
+        m_value = std::monostate{};
+
+        return result;
+    }
+
     [[nodiscard]] const auto& operator[](const Object::key_type& key) const {
         return get_strict<Object>().at(key);
     }
@@ -293,9 +666,139 @@ public:
         return !(*this == other);
     }
 
-    [[nodiscard]] bool operator==(const Value& other) const noexcept = default;
+    [[nodiscard]] bool operator==(const Value& other) const noexcept {
+        if (is<String>() && other.is<String>()) {
+            return get_strict<String>() == other.get_strict<String>();
+        }
+
+        if (is<PackedArray>() == other.is<PackedArray>()) {
+            return m_value == other.m_value;
+        }
+
+        return is<Array>() && other.is<Array>() &&
+               get_strict<Array>() == other.get_strict<Array>();
+    }
 
 private:
+    // Like get_strict, but never turns an undefined value into an empty one.
+    template <typename ValueType> [[nodiscard]] ValueType& get_movable() {
+        (void)std::as_const(*this).template get_strict<ValueType>();
+
+        if constexpr (std::is_same_v<ValueType, String>) {
+            unshare();
+        }
+
+        return get_impl<ValueType>();
+    }
+
+    // Whether get<ValueType>() would succeed, checking arrays and objects
+    // element by element without copying them.
+    template <typename ValueType>
+    [[nodiscard]] bool converts_to() const noexcept {
+        if constexpr (
+            details::StdVector<ValueType> &&
+            !std::is_same_v<ValueType, Array>) {
+            using Element = typename ValueType::value_type;
+
+            if (is<PackedArray>()) {
+                return get_impl<PackedArray>().visit([](auto elements) {
+                    using Packed = typename decltype(elements)::value_type;
+                    return elements.empty() ||
+                           Value{Packed{}}.template converts_to<Element>();
+                });
+            }
+
+            return is<Array>() &&
+                   std::ranges::all_of(
+                       get_impl<Array>(), [](const auto& element) {
+                           return element.template converts_to<Element>();
+                       });
+        } else if constexpr (
+            (details::StdMap<ValueType> ||
+             details::StdUnorderedMap<ValueType>) &&
+            !std::is_same_v<ValueType, Object>) {
+            using Mapped = typename ValueType::mapped_type;
+
+            return is<Object>() &&
+                   std::ranges::all_of(
+                       get_impl<Object>(), [](const auto& member) {
+                           return member.second
+                               .template converts_to<Mapped>();
+                       });
+        } else if constexpr (
+            std::is_same_v<ValueType, Array> ||
+            std::is_same_v<ValueType, Object> ||
+            std::is_same_v<ValueType, String>) {
+            return is<ValueType>();
+        } else {
+            try {
+                (void)get<ValueType>();
+                return true;
+            } catch (...) {
+                return false;
+            }
+        }
+    }
+
+    // Moves the value out as get() && does, but without checking it first.
+    template <typename ValueType> [[nodiscard]] auto convert() && {
+        if constexpr (
+            details::StdVector<ValueType> &&
+            !std::is_same_v<ValueType, Array>) {
+            if (is<PackedArray>()) {
+                return std::as_const(*this).template get<ValueType>();
+            }
+
+            auto& array = get_impl<Array>();
+
+            ValueType result;
+            result.reserve(array.size());
+
+            for (auto& value : array) {
+                result.push_back(
+                    std::move(value)
+                        .template convert<typename ValueType::value_type>());
+            }
+
+            return result;
+        } else if constexpr (
+            (details::StdMap<ValueType> ||
+             details::StdUnorderedMap<ValueType>) &&
+            !std::is_same_v<ValueType, Object>) {
+            auto& object = get_impl<Object>();
+
+            ValueType result;
+
+            if constexpr (details::StdUnorderedMap<ValueType>) {
+                result.reserve(object.size());
+            }
+
+            // Extracting the members releases their keys for moving as well.
+            while (!object.empty()) {
+                auto member = object.extract(object.begin());
+
+                result[typename ValueType::key_type{std::move(member.key())}] =
+                    std::move(member.mapped())
+                        .template convert<typename ValueType::mapped_type>();
+            }
+
+            return result;
+        } else {
+            return std::move(*this).template get<ValueType>();
+        }
+    }
+
+    // Destroys the children of an array or object without recursing deeper
+    // than DestructionState::max_depth.
+    void destroy_children() noexcept;
+
+    // Replaces a shared string with a copy that this value owns.
+    void unshare() {
+        if (std::holds_alternative<SharedString>(m_value)) {
+            m_value = String{*get_impl<SharedString>()};
+        }
+    }
+
     template <typename ValueType> [[nodiscard]] ValueType& get_impl() {
         return std::get<ValueType>(m_value);
     }
@@ -308,6 +811,106 @@ private:
     details::ValueType m_value;
 };
 
+inline Value::~Value() {
+    // Only arrays and objects hold other values.
+    static_assert(
+        static_cast<std::size_t>(Type::Object) ==
+        static_cast<std::size_t>(Type::Array) + 1);
+
+    if (m_value.index() - static_cast<std::size_t>(Type::Array) <= 1) {
+        destroy_children();
+    }
+}
+
+inline void Value::destroy_children() noexcept {
+    auto& state = details::destruction_state;
+
+    if (state.depth == 0) {
+        std::vector<details::ValueType> deferred;
+
+        state.deferred = &deferred;
+        state.depth = 1;
+
+        m_value = std::monostate{};
+
+        while (!deferred.empty()) {
+            auto value = std::move(deferred.back());
+            deferred.pop_back();
+
+            value = std::monostate{};
+        }
+
+        state.depth = 0;
+        state.deferred = nullptr;
+
+        return;
+    }
+
+    if (state.depth >= details::DestructionState::max_depth) {
+        state.deferred->push_back(std::move(m_value));
+        return;
+    }
+
+    ++state.depth;
+    m_value = std::monostate{};
+    --state.depth;
+}
+
+inline PackedArray::~PackedArray() { delete m_unpacked.load(); }
+
+inline PackedArray& PackedArray::operator=(PackedArray&& other) noexcept {
+    m_storage = std::move(other.m_storage);
+    delete m_unpacked.exchange(other.m_unpacked.exchange(nullptr));
+
+    return *this;
+}
+
+inline bool PackedArray::push_back(const Value& value) {
+    drop_unpacked();
+
+    switch (value.get_type()) {
+    case Value::Type::UInt:
+        return push_back_as(value.get_strict<UInt>());
+    case Value::Type::Int:
+        return push_back_as(value.get_strict<Int>());
+    case Value::Type::Float:
+        return push_back_as(value.get_strict<Float>());
+    case Value::Type::Bool:
+        return push_back_as(value.get_strict<Bool>());
+    default:
+        return false;
+    }
+}
+
+inline Array PackedArray::unpack() const {
+    return visit([](auto elements) {
+        Array result;
+        result.reserve(elements.size());
+
+        for (auto element : elements) {
+            result.emplace_back(element);
+        }
+
+        return result;
+    });
+}
+
+inline const Array& PackedArray::unpacked() const {
+    auto* unpacked = m_unpacked.load(std::memory_order_acquire);
+
+    if (unpacked == nullptr) {
+        auto created = std::make_unique<Array>(unpack());
+
+        if (m_unpacked.compare_exchange_strong(
+                unpacked, created.get(), std::memory_order_acq_rel,
+                std::memory_order_acquire)) {
+            unpacked = created.release();
+        }
+    }
+
+    return *unpacked;
+}
+
 } // namespace lumen
 
 #endif
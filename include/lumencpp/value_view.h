@@ -0,0 +1,318 @@
+#ifndef LUMENCPP_VALUE_VIEW_H
+#define LUMENCPP_VALUE_VIEW_H
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "exceptions.h"
+#include "value.h"
+
+namespace lumen {
+
+namespace details {
+
+// A node of a read-only document stored as a flat table. Children of an array
+// or an object are stored next to each other, the members of an object sorted
+// by key, and every string lives in a single pool, so a table holds no
+// pointers and can be placed anywhere in memory.
+struct FlatNode {
+    Value::Type type = Value::Type::Undefined;
+
+    // Spelled out rather than left to the compiler, so that nodes written to
+    // a file have no bytes of indeterminate value.
+    std::array<std::uint8_t, 3> padding{};
+
+    // Length of a string or number of children of an array or an object.
+    std::uint32_t size = 0;
+
+    // Bits of a scalar, offset of a string in the pool or index of the first
+    // child of an array or an object.
+    std::uint64_t payload = 0;
+
+    // Key in the pool when the parent is an object.
+    std::uint32_t key_offset = 0;
+    std::uint32_t key_size = 0;
+};
+
+} // namespace details
+
+class ValueView {
+public:
+    class Iterator;
+
+    [[nodiscard]] constexpr ValueView() noexcept = default;
+
+    [[nodiscard]] constexpr ValueView(
+        std::span<const details::FlatNode> nodes, std::string_view strings,
+        std::size_t index = 0) noexcept
+    : m_nodes{nodes}, m_strings{strings}, m_index{index} {}
+
+    [[nodiscard]] constexpr Value::Type get_type() const noexcept {
+        return node().type;
+    }
+
+    [[nodiscard]] constexpr bool is(Value::Type type) const noexcept {
+        return get_type() == type;
+    }
+
+    template <typename ValueType>
+    [[nodiscard]] constexpr bool is() const noexcept {
+        if constexpr (std::is_same_v<ValueType, UInt>) {
+            return is(Value::Type::UInt);
+        } else if constexpr (std::is_same_v<ValueType, Int>) {
+            return is(Value::Type::Int);
+        } else if constexpr (std::is_same_v<ValueType, Float>) {
+            return is(Value::Type::Float);
+        } else if constexpr (std::is_same_v<ValueType, Bool>) {
+            return is(Value::Type::Bool);
+        } else if constexpr (
+            std::is_same_v<ValueType, String> ||
+            std::is_same_v<ValueType, std::string_view>) {
+            return is(Value::Type::String);
+        } else if constexpr (std::is_same_v<ValueType, Array>) {
+            return is(Value::Type::Array);
+        } else if constexpr (std::is_same_v<ValueType, Object>) {
+            return is(Value::Type::Object);
+        } else {
+            return false;
+        }
+    }
+
+    // Number of elements of an array or members of an object.
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return is(Value::Type::Array) || is(Value::Type::Object) ? node().size
+                                                                 : 0;
+    }
+
+    [[nodiscard]] constexpr Iterator begin() const noexcept;
+    [[nodiscard]] constexpr Iterator end() const noexcept;
+
+    // Key of a member of an object.
+    [[nodiscard]] constexpr std::string_view key() const noexcept {
+        return m_strings.substr(node().key_offset, node().key_size);
+    }
+
+    template <std::integral Integral>
+        requires(!std::is_same_v<Integral, Bool>)
+    [[nodiscard]] constexpr auto get() const {
+        if (is<UInt>()) {
+            return static_cast<Integral>(node().payload);
+        }
+
+        return static_cast<Integral>(
+            static_cast<Int>(strict(Value::Type::Int).payload));
+    }
+
+    template <std::same_as<Bool>> [[nodiscard]] constexpr auto get() const {
+        return strict(Value::Type::Bool).payload != 0;
+    }
+
+    template <std::floating_point FloatingPoint>
+    [[nodiscard]] constexpr auto get() const {
+        if (is<UInt>()) {
+            return static_cast<FloatingPoint>(node().payload);
+        }
+
+        if (is<Int>()) {
+            return static_cast<FloatingPoint>(
+                static_cast<Int>(node().payload));
+        }
+
+        return static_cast<FloatingPoint>(
+            std::bit_cast<Float>(strict(Value::Type::Float).payload));
+    }
+
+    template <std::same_as<std::string_view>>
+    [[nodiscard]] constexpr auto get() const {
+        const auto& string = strict(Value::Type::String);
+        return m_strings.substr(string.payload, string.size);
+    }
+
+    template <std::constructible_from<std::string_view> StringLike>
+        requires(
+            !std::is_same_v<StringLike, std::string_view> &&
+            !std::is_same_v<StringLike, Bool>)
+    [[nodiscard]] constexpr auto get() const {
+        return StringLike{get<std::string_view>()};
+    }
+
+    template <details::StdVector Vector>
+    [[nodiscard]] constexpr auto get() const {
+        strict(Value::Type::Array);
+
+        Vector result;
+        result.reserve(size());
+
+        for (std::size_t i = 0; i < size(); ++i) {
+            result.push_back(
+                child(i).template get<typename Vector::value_type>());
+        }
+
+        return result;
+    }
+
+    template <typename Map>
+        requires(
+            (details::StdMap<Map> || details::StdUnorderedMap<Map>) &&
+            std::is_constructible_v<typename Map::key_type, std::string_view>)
+    [[nodiscard]] auto get() const {
+        strict(Value::Type::Object);
+
+        Map result;
+
+        for (std::size_t i = 0; i < size(); ++i) {
+            auto member = child(i);
+
+            result[typename Map::key_type{member.key()}] =
+                member.template get<typename Map::mapped_type>();
+        }
+
+        return result;
+    }
+
+    template <typename ValueType>
+    [[nodiscard]] constexpr auto get_or(ValueType value) const noexcept {
+        try {
+            return get<ValueType>();
+        } catch (...) {
+            return value;
+        }
+    }
+
+    [[nodiscard]] constexpr bool contains(std::string_view key) const {
+        return find(key) != size();
+    }
+
+    [[nodiscard]] constexpr ValueView operator[](std::string_view key) const {
+        auto index = find(key);
+
+        if (index == size()) {
+            throw std::out_of_range{"key not found"};
+        }
+
+        return child(index);
+    }
+
+    [[nodiscard]] constexpr ValueView operator[](std::size_t index) const {
+        strict(Value::Type::Array);
+        return child(index);
+    }
+
+    template <typename ValueType>
+    [[nodiscard]] constexpr bool
+    operator==(const ValueType& other) const noexcept {
+        try {
+            return get<ValueType>() == other;
+        } catch (...) {
+            return false;
+        }
+    }
+
+private:
+    [[nodiscard]] constexpr const details::FlatNode& node() const noexcept {
+        return m_nodes[m_index];
+    }
+
+    constexpr const details::FlatNode& strict(Value::Type type) const {
+        if (get_type() != type) {
+            if (get_type() == Value::Type::Undefined) {
+                throw TypeMismatch{"attempted to retrieve an undefined value"};
+            }
+
+            throw TypeMismatch{
+                "attempted to retrieve a value with an incompatible type"};
+        }
+
+        return node();
+    }
+
+    [[nodiscard]] constexpr ValueView child(std::size_t index) const noexcept {
+        return {m_nodes, m_strings, node().payload + index};
+    }
+
+    // Returns the index of the member or size() if there is none.
+    [[nodiscard]] constexpr std::size_t find(std::string_view key) const {
+        strict(Value::Type::Object);
+
+        std::size_t begin = 0;
+        std::size_t end = size();
+
+        while (begin < end) {
+            auto middle = begin + (end - begin) / 2;
+            auto middle_key = child(middle).key();
+
+            if (middle_key == key) {
+                return middle;
+            }
+
+            if (middle_key < key) {
+                begin = middle + 1;
+            } else {
+                end = middle;
+            }
+        }
+
+        return size();
+    }
+
+    std::span<const details::FlatNode> m_nodes;
+    std::string_view m_strings;
+
+    std::size_t m_index = 0;
+};
+
+class ValueView::Iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ValueView;
+    using difference_type = std::ptrdiff_t;
+
+    [[nodiscard]] constexpr Iterator() noexcept = default;
+
+    [[nodiscard]] constexpr explicit Iterator(ValueView view) noexcept
+    : m_view{view} {}
+
+    [[nodiscard]] constexpr ValueView operator*() const noexcept {
+        return m_view;
+    }
+
+    constexpr Iterator& operator++() noexcept {
+        ++m_view.m_index;
+        return *this;
+    }
+
+    constexpr Iterator operator++(int) noexcept {
+        auto result = *this;
+        ++*this;
+
+        return result;
+    }
+
+    [[nodiscard]] constexpr bool
+    operator==(const Iterator& other) const noexcept {
+        return m_view.m_index == other.m_view.m_index;
+    }
+
+private:
+    ValueView m_view{};
+};
+
+constexpr ValueView::Iterator ValueView::begin() const noexcept {
+    return Iterator{child(0)};
+}
+
+constexpr ValueView::Iterator ValueView::end() const noexcept {
+    return Iterator{child(size())};
+}
+
+} // namespace lumen
+
+#endif
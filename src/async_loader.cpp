@@ -0,0 +1,547 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+#define LUMENCPP_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include "../include/lumencpp/async_loader.h"
+#include "../include/lumencpp/blocking_queue.h"
+
+namespace lumen {
+
+namespace {
+
+// The content of a file, or why it could not be read.
+struct Source {
+    std::size_t index = 0;
+    std::string content;
+    std::exception_ptr error;
+};
+
+using SourceQueue = details::BlockingQueue<Source>;
+using ResultQueue = details::BlockingQueue<AsyncLoader::Result>;
+
+class Descriptor {
+public:
+    [[nodiscard]] explicit Descriptor(int descriptor = -1) noexcept
+    : m_descriptor{descriptor} {}
+
+    [[nodiscard]] Descriptor(Descriptor&& other) noexcept
+    : m_descriptor{std::exchange(other.m_descriptor, -1)} {}
+
+    ~Descriptor() {
+        if (m_descriptor >= 0) {
+            ::close(m_descriptor);
+        }
+    }
+
+    Descriptor& operator=(Descriptor&& other) noexcept {
+        std::swap(m_descriptor, other.m_descriptor);
+        return *this;
+    }
+
+    [[nodiscard]] int get() const noexcept { return m_descriptor; }
+
+private:
+    int m_descriptor;
+};
+
+[[nodiscard]] std::exception_ptr
+io_error(const std::filesystem::path& path, const std::string& action) {
+    return std::make_exception_ptr(
+        IOError{"unable to " + action + " '" + path.string() + "'"});
+}
+
+// Reads with plain system calls, which also works for files that do not know
+// their size up front.
+[[nodiscard]] Source
+read_blocking(std::size_t index, const std::filesystem::path& path) {
+    Source result{index, {}, {}};
+
+    try {
+        Descriptor file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+
+        if (file.get() < 0) {
+            result.error = io_error(path, "open");
+            return result;
+        }
+
+        struct stat status {};
+
+        if (::fstat(file.get(), &status) == 0 && S_ISREG(status.st_mode)) {
+            result.content.resize(static_cast<std::size_t>(status.st_size));
+        }
+
+        std::size_t size = 0;
+
+        while (true) {
+            // Probes for more content than the file claimed to have.
+            char overflow[4096];
+            bool is_full = size == result.content.size();
+
+            auto* target = is_full ? overflow : result.content.data() + size;
+            auto capacity =
+                is_full ? sizeof(overflow) : result.content.size() - size;
+
+            auto count = ::read(file.get(), target, capacity);
+
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count < 0) {
+                result.error = io_error(path, "read");
+                return result;
+            }
+
+            if (count == 0) {
+                break;
+            }
+
+            if (is_full) {
+                result.content.append(
+                    overflow, static_cast<std::size_t>(count));
+            }
+
+            size += static_cast<std::size_t>(count);
+        }
+
+        result.content.resize(size);
+    } catch (...) {
+        result.error = std::current_exception();
+    }
+
+    return result;
+}
+
+void read_with_threads(
+    std::span<const std::filesystem::path> paths, SourceQueue& sources,
+    std::size_t thread_count) {
+    std::atomic<std::size_t> next = 0;
+    std::vector<std::jthread> readers;
+
+    for (std::size_t i = 0; i < thread_count; ++i) {
+        readers.emplace_back([&] {
+            for (auto index = next++; index < paths.size(); index = next++) {
+                if (!sources.push(read_blocking(index, paths[index]))) {
+                    return;
+                }
+            }
+        });
+    }
+}
+
+#ifdef LUMENCPP_IO_URING
+
+class Mapping {
+public:
+    [[nodiscard]] Mapping() noexcept = default;
+
+    [[nodiscard]] Mapping(int descriptor, std::size_t size, off_t offset)
+    : m_data{::mmap(
+          nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+          descriptor, offset)},
+      m_size{size} {
+        if (m_data == MAP_FAILED) {
+            throw std::system_error{errno, std::system_category(), "mmap"};
+        }
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    ~Mapping() {
+        if (m_data != MAP_FAILED) {
+            ::munmap(m_data, m_size);
+        }
+    }
+
+    template <typename Field>
+    [[nodiscard]] Field* at(std::uint32_t offset) const noexcept {
+        return reinterpret_cast<Field*>(static_cast<char*>(m_data) + offset);
+    }
+
+private:
+    void* m_data = MAP_FAILED;
+    std::size_t m_size = 0;
+};
+
+// A minimal io_uring driven by raw system calls; not thread-safe.
+class Ring {
+public:
+    [[nodiscard]] explicit Ring(unsigned entries) {
+        io_uring_params parameters{};
+
+        m_ring = Descriptor{static_cast<int>(
+            ::syscall(__NR_io_uring_setup, entries, &parameters))};
+
+        if (m_ring.get() < 0) {
+            throw std::system_error{
+                errno, std::system_category(), "io_uring_setup"};
+        }
+
+        auto submission_size =
+            parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+        auto completion_size =
+            parameters.cq_off.cqes +
+            parameters.cq_entries * sizeof(io_uring_cqe);
+
+        bool is_single = (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+        if (is_single) {
+            submission_size = std::max(submission_size, completion_size);
+        }
+
+        m_submission.emplace(
+            m_ring.get(), submission_size, IORING_OFF_SQ_RING);
+
+        if (!is_single) {
+            m_completion.emplace(
+                m_ring.get(), completion_size, IORING_OFF_CQ_RING);
+        }
+
+        m_entries.emplace(
+            m_ring.get(), parameters.sq_entries * sizeof(io_uring_sqe),
+            IORING_OFF_SQES);
+
+        const auto& completion = is_single ? *m_submission : *m_completion;
+        const auto& sq = parameters.sq_off;
+        const auto& cq = parameters.cq_off;
+
+        m_sq_head = m_submission->at<unsigned>(sq.head);
+        m_sq_tail = m_submission->at<unsigned>(sq.tail);
+        m_sq_mask = *m_submission->at<unsigned>(sq.ring_mask);
+        m_sq_array = m_submission->at<unsigned>(sq.array);
+        m_sq_size = parameters.sq_entries;
+        m_sqes = m_entries->at<io_uring_sqe>(0);
+
+        m_cq_head = completion.at<unsigned>(cq.head);
+        m_cq_tail = completion.at<unsigned>(cq.tail);
+        m_cq_mask = *completion.at<unsigned>(cq.ring_mask);
+        m_cqes = completion.at<io_uring_cqe>(cq.cqes);
+    }
+
+    // Queues a read; returns false if the submission queue is full.
+    bool read(
+        int descriptor, char* buffer, std::size_t size, std::uint64_t offset,
+        std::uint64_t user_data) noexcept {
+        auto head = std::atomic_ref{*m_sq_head}.load(std::memory_order_acquire);
+        auto tail = *m_sq_tail;
+
+        if (tail - head == m_sq_size) {
+            return false;
+        }
+
+        auto slot = tail & m_sq_mask;
+
+        m_sqes[slot] = {};
+        m_sqes[slot].opcode = IORING_OP_READ;
+        m_sqes[slot].fd = descriptor;
+        m_sqes[slot].addr = reinterpret_cast<std::uint64_t>(buffer);
+        m_sqes[slot].len =
+            static_cast<std::uint32_t>(std::min<std::size_t>(size, 1U << 30));
+        m_sqes[slot].off = offset;
+        m_sqes[slot].user_data = user_data;
+        m_sq_array[slot] = slot;
+
+        std::atomic_ref{*m_sq_tail}.store(tail + 1, std::memory_order_release);
+        ++m_unsubmitted;
+
+        return true;
+    }
+
+    // Submits the queued reads and waits until one of them completes.
+    void submit_and_wait() {
+        auto result = ::syscall(
+            __NR_io_uring_enter, m_ring.get(), m_unsubmitted, 1,
+            IORING_ENTER_GETEVENTS, nullptr, 0);
+
+        if (result >= 0) {
+            m_unsubmitted -= static_cast<unsigned>(result);
+        } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            throw std::system_error{
+                errno, std::system_category(), "io_uring_enter"};
+        }
+    }
+
+    // Calls the handler with the user data and result of every completion.
+    template <typename Handler> void reap(Handler&& handler) {
+        auto head = *m_cq_head;
+        auto tail = std::atomic_ref{*m_cq_tail}.load(std::memory_order_acquire);
+
+        for (; head != tail; ++head) {
+            auto completion = m_cqes[head & m_cq_mask];
+            std::atomic_ref{*m_cq_head}.store(
+                head + 1, std::memory_order_release);
+
+            handler(completion.user_data, completion.res);
+        }
+    }
+
+private:
+    Descriptor m_ring;
+
+    std::optional<Mapping> m_submission;
+    std::optional<Mapping> m_completion;
+    std::optional<Mapping> m_entries;
+
+    unsigned* m_sq_head = nullptr;
+    unsigned* m_sq_tail = nullptr;
+    unsigned m_sq_mask = 0;
+    unsigned* m_sq_array = nullptr;
+    unsigned m_sq_size = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    unsigned m_unsubmitted = 0;
+
+    unsigned* m_cq_head = nullptr;
+    unsigned* m_cq_tail = nullptr;
+    unsigned m_cq_mask = 0;
+    io_uring_cqe* m_cqes = nullptr;
+};
+
+// Keeps up to `depth` reads in flight. Files are opened synchronously, as
+// opening is cheap next to reading; failed reads are retried with plain
+// system calls, which also covers kernels without IORING_OP_READ.
+void read_with_io_uring(
+    Ring& ring, std::span<const std::filesystem::path> paths,
+    SourceQueue& sources, std::size_t depth) {
+    struct Pending {
+        std::size_t index = 0;
+        Descriptor file;
+        std::string content;
+        std::size_t size = 0;
+    };
+
+    std::vector<Pending> pending(depth);
+    std::vector<std::size_t> free_slots(depth);
+
+    for (std::size_t slot = 0; slot < depth; ++slot) {
+        free_slots[slot] = depth - slot - 1;
+    }
+
+    std::size_t next = 0;
+    std::size_t in_flight = 0;
+    bool is_stopped = false;
+
+    auto finish = [&](Source source) {
+        is_stopped = is_stopped || !sources.push(std::move(source));
+    };
+
+    auto read = [&](std::size_t slot) {
+        auto& file = pending[slot];
+
+        (void)ring.read(
+            file.file.get(), file.content.data() + file.size,
+            file.content.size() - file.size, file.size, slot);
+    };
+
+    while (in_flight > 0 || (next < paths.size() && !is_stopped)) {
+        for (; !is_stopped && next < paths.size() && !free_slots.empty();
+             ++next) {
+            const auto& path = paths[next];
+            Descriptor file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+
+            struct stat status {};
+
+            if (file.get() < 0 || ::fstat(file.get(), &status) != 0 ||
+                !S_ISREG(status.st_mode) || status.st_size == 0) {
+                finish(read_blocking(next, path));
+                continue;
+            }
+
+            auto slot = free_slots.back();
+            free_slots.pop_back();
+
+            pending[slot].index = next;
+            pending[slot].file = std::move(file);
+            pending[slot].content.resize(
+                static_cast<std::size_t>(status.st_size));
+            pending[slot].size = 0;
+
+            read(slot);
+            ++in_flight;
+        }
+
+        if (in_flight == 0) {
+            continue;
+        }
+
+        ring.submit_and_wait();
+        ring.reap([&](std::uint64_t slot, std::int32_t result) {
+            auto& file = pending[slot];
+
+            if (result == -EINTR || result == -EAGAIN) {
+                read(slot);
+                return;
+            }
+
+            if (result > 0) {
+                file.size += static_cast<std::size_t>(result);
+
+                if (file.size < file.content.size()) {
+                    read(slot);
+                    return;
+                }
+            }
+
+            if (result < 0) {
+                finish(read_blocking(file.index, paths[file.index]));
+            } else {
+                // A file that grew since it was opened is cut at its old
+                // size, as any other snapshot would be.
+                file.content.resize(file.size);
+                finish({file.index, std::move(file.content), {}});
+            }
+
+            file.file = Descriptor{};
+            file.content = {};
+
+            free_slots.push_back(slot);
+            --in_flight;
+        });
+    }
+}
+
+#endif
+
+} // namespace
+
+void AsyncLoader::load(
+    std::span<const std::filesystem::path> paths,
+    const Callback& callback) const {
+    if (paths.empty()) {
+        return;
+    }
+
+    auto depth = std::clamp<std::size_t>(m_options.queue_depth, 1, 4096);
+
+    auto parse_threads = m_options.parse_threads;
+
+    if (parse_threads == 0) {
+        parse_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    parse_threads = std::min(parse_threads, paths.size());
+
+#ifdef LUMENCPP_IO_URING
+    std::optional<Ring> ring;
+
+    if (m_options.use_io_uring) {
+        try {
+            ring.emplace(static_cast<unsigned>(depth));
+        } catch (const std::system_error&) {
+        }
+    }
+#endif
+
+    // Parsed files wait for the callback without a bound, so that reading
+    // and parsing go on while it runs.
+    SourceQueue sources{depth};
+    ResultQueue results;
+
+    std::exception_ptr failure;
+    std::vector<std::jthread> threads;
+
+    try {
+        threads.emplace_back([&] {
+            try {
+#ifdef LUMENCPP_IO_URING
+                if (ring) {
+                    read_with_io_uring(*ring, paths, sources, depth);
+                } else {
+                    read_with_threads(
+                        paths, sources, std::min(depth, paths.size()));
+                }
+#else
+                read_with_threads(
+                    paths, sources, std::min(depth, paths.size()));
+#endif
+            } catch (...) {
+                failure = std::current_exception();
+                results.close();
+            }
+
+            sources.close();
+        });
+
+        for (std::size_t i = 0; i < parse_threads; ++i) {
+            threads.emplace_back([&] {
+                while (auto source = sources.pop()) {
+                    Result result{
+                        source->index, paths[source->index], {}, {}, {}};
+                    result.error = source->error;
+
+                    if (!result.error) {
+                        auto options = m_options.parse_options;
+
+                        if (options.diagnostics != nullptr) {
+                            options.diagnostics = &result.diagnostics;
+                        }
+
+                        try {
+                            result.document = parse(
+                                source->content, result.path.string(), {},
+                                options);
+                        } catch (...) {
+                            result.error = std::current_exception();
+                        }
+                    }
+
+                    if (!results.push(std::move(result))) {
+                        return;
+                    }
+                }
+            });
+        }
+
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            auto result = results.pop();
+
+            if (!result) {
+                std::rethrow_exception(failure);
+            }
+
+            callback(std::move(*result));
+        }
+    } catch (...) {
+        sources.close();
+        results.close();
+
+        throw;
+    }
+}
+
+bool AsyncLoader::io_uring_available() {
+#ifdef LUMENCPP_IO_URING
+    static const bool is_available = [] {
+        try {
+            Ring ring{1};
+            return true;
+        } catch (const std::system_error&) {
+            return false;
+        }
+    }();
+
+    return is_available;
+#else
+    return false;
+#endif
+}
+
+} // namespace lumen
@@ -0,0 +1,447 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "../include/lumencpp/cursor.h"
+
+namespace lumen {
+
+namespace {
+
+// Elements of a packed array are not stored as values, so they are read
+// into one.
+[[nodiscard]] Value
+packed_element(const PackedArray& packed, std::size_t index) {
+    return packed.visit(
+        [index](auto elements) { return Value{elements[index]}; });
+}
+
+// Keys are preceded by a dot unless they are the outermost segment.
+void append_segment(
+    std::string& path, const details::PathSegment& segment,
+    bool is_outermost) {
+    if (segment.key != nullptr) {
+        if (!is_outermost) {
+            path += '.';
+        }
+
+        path += *segment.key;
+        return;
+    }
+
+    char digits[20];
+    auto [end, error] =
+        std::to_chars(digits, digits + sizeof(digits), segment.index);
+
+    path += '[';
+    path.append(digits, end);
+    path += ']';
+}
+
+void walk(
+    DepthFirstCursor cursor, const TraversalVisitor& visitor,
+    const std::atomic<bool>& is_stopped) {
+    while (!cursor.done() && !is_stopped.load(std::memory_order_relaxed)) {
+        if (visitor(cursor)) {
+            cursor.next();
+        } else {
+            cursor.skip();
+        }
+    }
+}
+
+// Runs task(i, is_stopped) for every i below `count`, taking the next i on
+// whichever thread is free.
+template <typename Task>
+void fan_out(std::size_t count, std::size_t threads, const Task& task) {
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    threads = std::min(threads, count);
+
+    std::atomic<std::size_t> next = 0;
+    std::atomic<bool> is_stopped = false;
+
+    std::mutex mutex;
+    std::exception_ptr failure;
+
+    auto work = [&] {
+        try {
+            for (auto i = next++; i < count && !is_stopped; i = next++) {
+                task(i, is_stopped);
+            }
+        } catch (...) {
+            std::lock_guard lock{mutex};
+
+            if (!failure) {
+                failure = std::current_exception();
+            }
+
+            is_stopped = true;
+        }
+    };
+
+    {
+        std::vector<std::jthread> helpers;
+
+        for (std::size_t i = 1; i < threads; ++i) {
+            helpers.emplace_back(work);
+        }
+
+        work();
+    }
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+} // namespace
+
+DepthFirstCursor::DepthFirstCursor(const Value& root) : m_value{&root} {}
+
+DepthFirstCursor::DepthFirstCursor(const Object& root) {
+    if (!root.empty()) {
+        m_frames.push_back(
+            {&root, root.begin(), nullptr, nullptr, nullptr, nullptr, 0});
+        m_value = &root.begin()->second;
+    }
+}
+
+DepthFirstCursor::DepthFirstCursor(const Object::value_type& member)
+: m_value{&member.second}, m_root{details::PathSegment{&member.first, 0}} {
+    append_segment(m_path, *m_root, true);
+    m_root_path_size = m_path.size();
+}
+
+DepthFirstCursor::DepthFirstCursor(const Value& element, std::size_t index)
+: m_value{&element}, m_root{details::PathSegment{nullptr, index}} {
+    append_segment(m_path, *m_root, true);
+    m_root_path_size = m_path.size();
+}
+
+std::string_view DepthFirstCursor::key() const noexcept {
+    auto current = segment();
+
+    if (!current.has_value() || current->key == nullptr) {
+        return {};
+    }
+
+    return *current->key;
+}
+
+std::size_t DepthFirstCursor::index() const noexcept {
+    auto current = segment();
+    return current.has_value() && current->key == nullptr ? current->index : 0;
+}
+
+bool DepthFirstCursor::is_element() const noexcept {
+    auto current = segment();
+    return current.has_value() && current->key == nullptr;
+}
+
+std::size_t DepthFirstCursor::depth() const noexcept {
+    return m_frames.size() + (m_root.has_value() ? 1 : 0);
+}
+
+std::string_view DepthFirstCursor::path() const {
+    std::size_t level = 0;
+    auto unchanged = std::min(m_rendered.size(), m_frames.size());
+
+    while (level < unchanged &&
+           m_rendered[level].position == position(m_frames[level])) {
+        ++level;
+    }
+
+    m_path.resize(level == 0 ? m_root_path_size : m_rendered[level - 1].end);
+    m_rendered.resize(level);
+
+    for (; level < m_frames.size(); ++level) {
+        const auto& frame = m_frames[level];
+
+        append_segment(
+            m_path, segment(frame), level == 0 && !m_root.has_value());
+        m_rendered.push_back({position(frame), m_path.size()});
+    }
+
+    return m_path;
+}
+
+void DepthFirstCursor::next() {
+    if (!descend()) {
+        skip();
+    }
+}
+
+void DepthFirstCursor::skip() {
+    while (!m_frames.empty()) {
+        auto& frame = m_frames.back();
+
+        if (frame.packed != nullptr) {
+            if (++frame.index != frame.packed->size()) {
+                m_element = packed_element(*frame.packed, frame.index);
+                return;
+            }
+        } else if (frame.object != nullptr) {
+            if (++frame.member != frame.object->end()) {
+                m_value = &frame.member->second;
+                return;
+            }
+        } else if (++frame.element != frame.end) {
+            m_value = frame.element;
+            return;
+        }
+
+        m_frames.pop_back();
+    }
+
+    m_value = nullptr;
+}
+
+details::PathSegment DepthFirstCursor::segment(const Frame& frame) noexcept {
+    if (frame.packed != nullptr) {
+        return {nullptr, frame.index};
+    }
+
+    if (frame.object != nullptr) {
+        return {&frame.member->first, 0};
+    }
+
+    return {nullptr, static_cast<std::size_t>(frame.element - frame.begin)};
+}
+
+const void* DepthFirstCursor::position(const Frame& frame) noexcept {
+    if (frame.packed != nullptr) {
+        return frame.packed->visit([&frame](auto elements) {
+            return static_cast<const void*>(&elements[frame.index]);
+        });
+    }
+
+    if (frame.object != nullptr) {
+        return &*frame.member;
+    }
+
+    return frame.element;
+}
+
+std::optional<details::PathSegment>
+DepthFirstCursor::segment() const noexcept {
+    if (m_frames.empty()) {
+        return m_root;
+    }
+
+    return segment(m_frames.back());
+}
+
+bool DepthFirstCursor::descend() {
+    // Elements of packed arrays are scalars.
+    if (m_value == nullptr) {
+        return false;
+    }
+
+    switch (m_value->get_type()) {
+    case Value::Type::Object: {
+        const auto& object = m_value->get_strict<Object>();
+
+        if (object.empty()) {
+            return false;
+        }
+
+        m_frames.push_back(
+            {&object, object.begin(), nullptr, nullptr, nullptr, nullptr, 0});
+        m_value = &object.begin()->second;
+
+        return true;
+    }
+    case Value::Type::Array: {
+        if (m_value->is<PackedArray>()) {
+            const auto& packed = m_value->get_strict<PackedArray>();
+
+            if (packed.empty()) {
+                return false;
+            }
+
+            m_frames.push_back(
+                {nullptr, {}, nullptr, nullptr, nullptr, &packed, 0});
+            m_value = nullptr;
+            m_element = packed_element(packed, 0);
+
+            return true;
+        }
+
+        const auto& array = m_value->get_strict<Array>();
+
+        if (array.empty()) {
+            return false;
+        }
+
+        const auto* begin = array.data();
+        m_frames.push_back(
+            {nullptr, {}, begin, begin, begin + array.size(), nullptr, 0});
+        m_value = begin;
+
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+BreadthFirstCursor::BreadthFirstCursor(const Value& root) {
+    m_entries.push_back({&root, nullptr, std::nullopt, none, 0});
+}
+
+BreadthFirstCursor::BreadthFirstCursor(const Object& root) {
+    m_entries.reserve(root.size());
+
+    for (const auto& [key, value] : root) {
+        m_entries.push_back(
+            {&value, nullptr, details::PathSegment{&key, 0}, none, 1});
+    }
+}
+
+const Value& BreadthFirstCursor::value() const noexcept {
+    const auto& entry = m_entries[m_position];
+
+    if (entry.value != nullptr) {
+        return *entry.value;
+    }
+
+    m_element = packed_element(*entry.packed, entry.segment->index);
+    return m_element;
+}
+
+std::string_view BreadthFirstCursor::key() const noexcept {
+    const auto& segment = m_entries[m_position].segment;
+
+    if (!segment.has_value() || segment->key == nullptr) {
+        return {};
+    }
+
+    return *segment->key;
+}
+
+std::size_t BreadthFirstCursor::index() const noexcept {
+    const auto& segment = m_entries[m_position].segment;
+    return segment.has_value() && segment->key == nullptr ? segment->index : 0;
+}
+
+bool BreadthFirstCursor::is_element() const noexcept {
+    const auto& segment = m_entries[m_position].segment;
+    return segment.has_value() && segment->key == nullptr;
+}
+
+std::size_t BreadthFirstCursor::depth() const noexcept {
+    return m_entries[m_position].depth;
+}
+
+std::string_view BreadthFirstCursor::path() const {
+    m_chain.clear();
+
+    for (auto entry = m_position; entry != none;
+         entry = m_entries[entry].parent) {
+        if (m_entries[entry].segment.has_value()) {
+            m_chain.push_back(entry);
+        }
+    }
+
+    m_path.clear();
+
+    for (auto entry = m_chain.rbegin(); entry != m_chain.rend(); ++entry) {
+        append_segment(
+            m_path, *m_entries[*entry].segment, entry == m_chain.rbegin());
+    }
+
+    return m_path;
+}
+
+void BreadthFirstCursor::next() {
+    // Elements of packed arrays are scalars.
+    if (m_entries[m_position].value == nullptr) {
+        ++m_position;
+        return;
+    }
+
+    const auto& value = *m_entries[m_position].value;
+
+    auto parent = m_position;
+    auto depth = m_entries[m_position].depth + 1;
+
+    if (value.is<Object>()) {
+        for (const auto& [key, member] : value.get_strict<Object>()) {
+            m_entries.push_back(
+                {&member, nullptr, details::PathSegment{&key, 0}, parent,
+                 depth});
+        }
+    } else if (value.is<PackedArray>()) {
+        const auto& packed = value.get_strict<PackedArray>();
+
+        for (std::size_t i = 0; i < packed.size(); ++i) {
+            m_entries.push_back(
+                {nullptr, &packed, details::PathSegment{nullptr, i}, parent,
+                 depth});
+        }
+    } else if (value.is<Array>()) {
+        const auto& array = value.get_strict<Array>();
+
+        for (std::size_t i = 0; i < array.size(); ++i) {
+            m_entries.push_back(
+                {&array[i], nullptr, details::PathSegment{nullptr, i}, parent,
+                 depth});
+        }
+    }
+
+    ++m_position;
+}
+
+void traverse_parallel(
+    const Object& root, const TraversalVisitor& visitor,
+    std::size_t threads) {
+    std::vector<const Object::value_type*> members;
+    members.reserve(root.size());
+
+    for (const auto& member : root) {
+        members.push_back(&member);
+    }
+
+    fan_out(
+        members.size(), threads,
+        [&](std::size_t i, const std::atomic<bool>& is_stopped) {
+            walk(DepthFirstCursor{*members[i]}, visitor, is_stopped);
+        });
+}
+
+void traverse_parallel(
+    const Value& root, const TraversalVisitor& visitor,
+    std::size_t threads) {
+    if (!visitor(DepthFirstCursor{root})) {
+        return;
+    }
+
+    if (root.is<Object>()) {
+        traverse_parallel(root.get_strict<Object>(), visitor, threads);
+    } else if (root.is<PackedArray>()) {
+        const auto& packed = root.get_strict<PackedArray>();
+
+        fan_out(
+            packed.size(), threads,
+            [&](std::size_t i, const std::atomic<bool>& is_stopped) {
+                auto element = packed_element(packed, i);
+                walk(DepthFirstCursor{element, i}, visitor, is_stopped);
+            });
+    } else if (root.is<Array>()) {
+        const auto& array = root.get_strict<Array>();
+
+        fan_out(
+            array.size(), threads,
+            [&](std::size_t i, const std::atomic<bool>& is_stopped) {
+                walk(DepthFirstCursor{array[i], i}, visitor, is_stopped);
+            });
+    }
+}
+
+} // namespace lumen
@@ -0,0 +1,231 @@
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string_view>
+#include <utility>
+
+#include <sys/stat.h>
+
+#include "../include/lumencpp/document_cache.h"
+
+namespace lumen {
+
+namespace {
+
+[[nodiscard]] std::size_t estimate_memory_usage(const Value& value);
+
+[[nodiscard]] std::size_t estimate_memory_usage(const Object& object) {
+    // Every member is a separately allocated node of the hash table.
+    constexpr auto node_size = sizeof(Object::value_type) + sizeof(void*) * 2;
+
+    auto result = object.bucket_count() * sizeof(void*);
+
+    for (const auto& [key, value] : object) {
+        result += node_size + key.capacity() +
+                  estimate_memory_usage(value) - sizeof(Value);
+    }
+
+    return result;
+}
+
+std::size_t estimate_memory_usage(const Value& value) {
+    auto result = sizeof(Value);
+
+    if (value.is<SharedString>()) {
+        // Shared strings are split evenly between their holders.
+        const auto& shared = value.get_strict<SharedString>();
+        result += shared->capacity() /
+                  static_cast<std::size_t>(shared.use_count());
+    } else if (value.is<String>()) {
+        result += value.get_strict<String>().capacity();
+    } else if (value.is<PackedArray>()) {
+        result += value.get_strict<PackedArray>().visit([](auto elements) {
+            return elements.size_bytes();
+        });
+    } else if (value.is<Array>()) {
+        for (const auto& element : value.get_strict<Array>()) {
+            result += estimate_memory_usage(element);
+        }
+    } else if (value.is<Object>()) {
+        result += estimate_memory_usage(value.get_strict<Object>());
+    }
+
+    return result;
+}
+
+[[nodiscard]] std::string read_file(const std::filesystem::path& path) {
+    std::ifstream file{path, std::ios::binary};
+
+    if (!file) {
+        throw IOError{"unable to open '" + path.string() + "'"};
+    }
+
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+
+    return std::move(buffer).str();
+}
+
+} // namespace
+
+DocumentCache& DocumentCache::global() {
+    static DocumentCache cache;
+    return cache;
+}
+
+std::shared_ptr<const Document>
+DocumentCache::parse_file(const std::filesystem::path& path) {
+    auto key = std::filesystem::absolute(path).lexically_normal().string();
+
+    std::unique_lock lock{m_mutex};
+
+    if (auto loading = m_loading.find(key); loading != m_loading.end()) {
+        auto result = loading->second;
+        lock.unlock();
+
+        return result.get();
+    }
+
+    if (auto entry = m_entries.find(key); entry != m_entries.end()) {
+        auto state = stat(path);
+
+        if (state == entry->second.state && !m_options.verify_content) {
+            m_recency.splice(
+                m_recency.begin(), m_recency, entry->second.recency);
+
+            return entry->second.document;
+        }
+    }
+
+    return load(path, key);
+}
+
+void DocumentCache::clear() {
+    std::lock_guard lock{m_mutex};
+
+    if (m_options.reaper != nullptr) {
+        for (auto& [key, entry] : m_entries) {
+            m_options.reaper->retire(std::move(entry.document));
+        }
+    }
+
+    m_entries.clear();
+    m_recency.clear();
+    m_memory_usage = 0;
+}
+
+std::size_t DocumentCache::memory_usage() const {
+    std::lock_guard lock{m_mutex};
+    return m_memory_usage;
+}
+
+DocumentCache::FileState
+DocumentCache::stat(const std::filesystem::path& path) {
+    struct stat status {};
+
+    if (::stat(path.c_str(), &status) != 0) {
+        throw IOError{"unable to stat '" + path.string() + "'"};
+    }
+
+    return {
+        static_cast<std::uint64_t>(status.st_dev),
+        static_cast<std::uint64_t>(status.st_ino),
+        static_cast<std::int64_t>(status.st_mtim.tv_sec) * 1000000000 +
+            status.st_mtim.tv_nsec,
+        static_cast<std::uint64_t>(status.st_size)};
+}
+
+// Called with the mutex locked; unlocks it while the file is read and parsed
+// so that other files can be served in the meantime.
+DocumentCache::Result DocumentCache::load(
+    const std::filesystem::path& path, const std::string& key) {
+    std::promise<Result> promise;
+    m_loading.emplace(key, promise.get_future().share());
+
+    std::optional<Entry> cached;
+
+    if (auto entry = m_entries.find(key); entry != m_entries.end()) {
+        cached = entry->second;
+    }
+
+    m_mutex.unlock();
+
+    Entry entry;
+    bool is_reused = false;
+
+    try {
+        entry.state = stat(path);
+
+        auto source = read_file(path);
+
+        if (m_options.verify_content) {
+            entry.content_hash = std::hash<std::string_view>{}(source);
+            is_reused = cached.has_value() &&
+                        cached->content_hash == entry.content_hash;
+        }
+
+        if (is_reused) {
+            entry.document = cached->document;
+            entry.memory_usage = cached->memory_usage;
+        } else {
+            auto document = std::make_shared<Document>(parse(
+                source, path.string(), {}, m_options.parse_options));
+
+            entry.memory_usage = estimate_memory_usage(document->data);
+            entry.document = std::move(document);
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+
+        m_mutex.lock();
+        m_loading.erase(key);
+
+        throw;
+    }
+
+    promise.set_value(entry.document);
+
+    m_mutex.lock();
+    m_loading.erase(key);
+
+    auto result = entry.document;
+    insert(key, std::move(entry));
+
+    return result;
+}
+
+void DocumentCache::insert(const std::string& key, Entry entry) {
+    if (auto old = m_entries.find(key); old != m_entries.end()) {
+        m_recency.erase(old->second.recency);
+        erase(old);
+    }
+
+    m_recency.push_front(key);
+    entry.recency = m_recency.begin();
+
+    m_memory_usage += entry.memory_usage;
+    m_entries.emplace(key, std::move(entry));
+
+    evict();
+}
+
+void DocumentCache::evict() {
+    // The most recent entry stays even when it alone exceeds the budget.
+    while (m_memory_usage > m_options.memory_budget && m_recency.size() > 1) {
+        erase(m_entries.find(m_recency.back()));
+        m_recency.pop_back();
+    }
+}
+
+void DocumentCache::erase(
+    std::unordered_map<std::string, Entry>::iterator entry) {
+    m_memory_usage -= entry->second.memory_usage;
+
+    if (m_options.reaper != nullptr) {
+        m_options.reaper->retire(std::move(entry->second.document));
+    }
+
+    m_entries.erase(entry);
+}
+
+} // namespace lumen
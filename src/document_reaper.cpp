@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "../include/lumencpp/document_reaper.h"
+
+namespace lumen {
+
+DocumentReaper::DocumentReaper(Options options)
+: m_queue{std::max<std::size_t>(options.capacity, 1)} {
+    m_thread = std::jthread{[this, options] {
+#ifdef __linux__
+        // Linux applies the nice value of a thread id to that thread alone.
+        if (options.lower_priority) {
+            auto thread = static_cast<id_t>(::gettid());
+            (void)::setpriority(PRIO_PROCESS, thread, 19);
+        }
+#else
+        (void)options;
+#endif
+
+        while (auto retired = m_queue.pop()) {
+            retired.reset();
+            release();
+        }
+    }};
+}
+
+DocumentReaper::~DocumentReaper() {
+    m_queue.close();
+    m_thread.join();
+}
+
+DocumentReaper& DocumentReaper::global() {
+    static DocumentReaper reaper;
+    return reaper;
+}
+
+void DocumentReaper::retire(Document document) { push(std::move(document)); }
+
+void DocumentReaper::retire(std::shared_ptr<const Document> document) {
+    if (document != nullptr) {
+        push(std::move(document));
+    }
+}
+
+void DocumentReaper::flush() {
+    std::unique_lock lock{m_mutex};
+    m_idle.wait(lock, [this] { return m_pending == 0; });
+}
+
+std::size_t DocumentReaper::pending() const {
+    std::lock_guard lock{m_mutex};
+    return m_pending;
+}
+
+void DocumentReaper::push(Retired retired) {
+    {
+        std::lock_guard lock{m_mutex};
+        ++m_pending;
+    }
+
+    if (!m_queue.try_push(retired)) {
+        // Destroys the document here, as if there were no reaper.
+        retired = Document{};
+        release();
+    }
+}
+
+void DocumentReaper::release() noexcept {
+    std::lock_guard lock{m_mutex};
+
+    if (--m_pending == 0) {
+        m_idle.notify_all();
+    }
+}
+
+} // namespace lumen
@@ -0,0 +1,176 @@
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#include "../include/lumencpp/fingerprint.h"
+#include "../include/lumencpp/swar.h"
+
+namespace lumen {
+
+namespace {
+
+enum struct Tag : std::uint64_t {
+    Undefined,
+    Integer,
+    NegativeInteger,
+    Float,
+    Bool,
+    String,
+    Array,
+    Object
+};
+
+[[nodiscard]] constexpr std::uint64_t mix(std::uint64_t word) noexcept {
+    word ^= word >> 33;
+    word *= 0xff51afd7ed558ccd;
+    word ^= word >> 33;
+    word *= 0xc4ceb9fe1a85ec53;
+    word ^= word >> 33;
+
+    return word;
+}
+
+[[nodiscard]] constexpr std::uint64_t
+combine(Tag tag, std::uint64_t word) noexcept {
+    return mix(word ^ mix(static_cast<std::uint64_t>(tag)));
+}
+
+[[nodiscard]] std::uint64_t load_little_endian(const char* bytes) noexcept {
+    if constexpr (details::swar::enabled) {
+        return details::swar::load(bytes);
+    }
+
+    std::uint64_t result = 0;
+
+    for (std::size_t i = 0; i < 8; ++i) {
+        result |= std::uint64_t{static_cast<unsigned char>(bytes[i])}
+                  << (i * 8);
+    }
+
+    return result;
+}
+
+[[nodiscard]] std::uint64_t hash_bytes(std::string_view bytes) noexcept {
+    constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15;
+
+    auto result = bytes.size() * multiplier;
+    std::size_t at = 0;
+
+    for (; bytes.size() - at >= 8; at += 8) {
+        result = (result ^ load_little_endian(&bytes[at])) * multiplier;
+        result ^= result >> 29;
+    }
+
+    std::uint64_t tail = 0;
+
+    for (std::size_t i = 0; at + i < bytes.size(); ++i) {
+        tail |= std::uint64_t{static_cast<unsigned char>(bytes[at + i])}
+                << (i * 8);
+    }
+
+    return mix((result ^ tail) * multiplier);
+}
+
+[[nodiscard]] std::uint64_t fingerprint_scalar(UInt value) noexcept {
+    return combine(Tag::Integer, value);
+}
+
+[[nodiscard]] std::uint64_t fingerprint_scalar(Int value) noexcept {
+    return combine(
+        value < 0 ? Tag::NegativeInteger : Tag::Integer,
+        static_cast<std::uint64_t>(value));
+}
+
+[[nodiscard]] std::uint64_t fingerprint_scalar(Float value) noexcept {
+    if (value == 0) {
+        value = 0;
+    } else if (std::isnan(value)) {
+        value = std::numeric_limits<Float>::quiet_NaN();
+    }
+
+    return combine(Tag::Float, std::bit_cast<std::uint64_t>(value));
+}
+
+[[nodiscard]] std::uint64_t fingerprint_scalar(Bool value) noexcept {
+    return combine(Tag::Bool, value ? 1 : 0);
+}
+
+[[nodiscard]] std::uint64_t
+member_term(std::string_view key, std::uint64_t value) noexcept {
+    return mix(hash_bytes(key) ^ std::rotl(value, 32));
+}
+
+} // namespace
+
+std::uint64_t fingerprint(const Value& value) {
+    switch (value.get_type()) {
+    case Value::Type::UInt:
+        return fingerprint_scalar(value.get_strict<UInt>());
+    case Value::Type::Int:
+        return fingerprint_scalar(value.get_strict<Int>());
+    case Value::Type::Float:
+        return fingerprint_scalar(value.get_strict<Float>());
+    case Value::Type::Bool:
+        return fingerprint_scalar(value.get_strict<Bool>());
+    case Value::Type::String:
+        return combine(Tag::String, hash_bytes(value.get_strict<String>()));
+    case Value::Type::Array:
+        if (value.is<PackedArray>()) {
+            return value.get_strict<PackedArray>().visit([](auto elements) {
+                auto result = combine(Tag::Array, elements.size());
+
+                for (auto element : elements) {
+                    result = mix(result + fingerprint_scalar(element));
+                }
+
+                return result;
+            });
+        }
+
+        return fingerprint(value.get_strict<Array>());
+    case Value::Type::Object:
+        return fingerprint(value.get_strict<Object>());
+    case Value::Type::Undefined:
+        break;
+    }
+
+    return combine(Tag::Undefined, 0);
+}
+
+std::uint64_t fingerprint(const Array& array) {
+    auto result = combine(Tag::Array, array.size());
+
+    for (const auto& element : array) {
+        result = mix(result + fingerprint(element));
+    }
+
+    return result;
+}
+
+std::uint64_t fingerprint(const Object& object) {
+    return ObjectFingerprint{object}.value();
+}
+
+ObjectFingerprint::ObjectFingerprint(const Object& object) {
+    for (const auto& [key, value] : object) {
+        add(key, fingerprint(value));
+    }
+}
+
+void ObjectFingerprint::add(
+    std::string_view key, std::uint64_t value) noexcept {
+    m_sum += member_term(key, value);
+    ++m_size;
+}
+
+void ObjectFingerprint::remove(
+    std::string_view key, std::uint64_t value) noexcept {
+    m_sum -= member_term(key, value);
+    --m_size;
+}
+
+std::uint64_t ObjectFingerprint::value() const noexcept {
+    return combine(Tag::Object, mix(m_sum) ^ m_size);
+}
+
+} // namespace lumen
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+#include "../include/lumencpp/frozen_document.h"
+
+namespace lumen {
+
+FrozenDocument::FrozenDocument(const Object& data) : m_nodes(1) {
+    write(data, 0);
+
+    m_nodes.shrink_to_fit();
+    m_strings.shrink_to_fit();
+}
+
+std::uint32_t FrozenDocument::add_string(std::string_view string) {
+    if (m_strings.size() + string.size() >
+        std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error{"frozen document strings exceed 4 GiB"};
+    }
+
+    auto offset = static_cast<std::uint32_t>(m_strings.size());
+    m_strings += string;
+
+    return offset;
+}
+
+void FrozenDocument::write(const Value& value, std::size_t index) {
+    m_nodes[index].type = value.get_type();
+
+    switch (value.get_type()) {
+    case Value::Type::UInt:
+        m_nodes[index].payload = value.get_strict<UInt>();
+        break;
+    case Value::Type::Int:
+        m_nodes[index].payload =
+            static_cast<std::uint64_t>(value.get_strict<Int>());
+        break;
+    case Value::Type::Float:
+        m_nodes[index].payload =
+            std::bit_cast<std::uint64_t>(value.get_strict<Float>());
+        break;
+    case Value::Type::Bool:
+        m_nodes[index].payload = value.get_strict<Bool>() ? 1 : 0;
+        break;
+    case Value::Type::String: {
+        const auto& string = value.get_strict<String>();
+
+        m_nodes[index].payload = add_string(string);
+        m_nodes[index].size = static_cast<std::uint32_t>(string.size());
+        break;
+    }
+    case Value::Type::Array: {
+        // Packed elements are frozen one by one without unpacking them first.
+        if (value.is<PackedArray>()) {
+            value.get_strict<PackedArray>().visit([&](auto elements) {
+                auto first = m_nodes.size();
+                m_nodes.resize(first + elements.size());
+
+                m_nodes[index].payload = first;
+                m_nodes[index].size =
+                    static_cast<std::uint32_t>(elements.size());
+
+                for (std::size_t i = 0; i < elements.size(); ++i) {
+                    write(Value{elements[i]}, first + i);
+                }
+            });
+
+            break;
+        }
+
+        const auto& array = value.get_strict<Array>();
+
+        auto first = m_nodes.size();
+        m_nodes.resize(first + array.size());
+
+        m_nodes[index].payload = first;
+        m_nodes[index].size = static_cast<std::uint32_t>(array.size());
+
+        for (std::size_t i = 0; i < array.size(); ++i) {
+            write(array[i], first + i);
+        }
+
+        break;
+    }
+    case Value::Type::Object:
+        write(value.get_strict<Object>(), index);
+        break;
+    case Value::Type::Undefined:
+        break;
+    }
+}
+
+void FrozenDocument::write(const Object& object, std::size_t index) {
+    std::vector<const Object::value_type*> members;
+    members.reserve(object.size());
+
+    for (const auto& member : object) {
+        members.push_back(&member);
+    }
+
+    std::sort(members.begin(), members.end(), [](auto lhs, auto rhs) {
+        return lhs->first < rhs->first;
+    });
+
+    auto first = m_nodes.size();
+    m_nodes.resize(first + members.size());
+
+    m_nodes[index].type = Value::Type::Object;
+    m_nodes[index].payload = first;
+    m_nodes[index].size = static_cast<std::uint32_t>(members.size());
+
+    for (std::size_t i = 0; i < members.size(); ++i) {
+        const auto& [key, value] = *members[i];
+
+        m_nodes[first + i].key_offset = add_string(key);
+        m_nodes[first + i].key_size = static_cast<std::uint32_t>(key.size());
+
+        write(value, first + i);
+    }
+}
+
+} // namespace lumen
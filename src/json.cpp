@@ -0,0 +1,762 @@
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "../include/lumencpp/exceptions.h"
+#include "../include/lumencpp/json.h"
+#include "../include/lumencpp/line_index.h"
+#include "../include/lumencpp/swar.h"
+#include "../include/lumencpp/utf8.h"
+
+namespace lumen {
+
+namespace {
+
+class JsonReader {
+public:
+    [[nodiscard]] JsonReader(
+        std::string_view source, std::string filename, std::size_t max_depth)
+    : m_source{source}, m_filename{std::move(filename)},
+      m_at{source.data()}, m_end{source.data() + source.size()},
+      m_max_depth{max_depth} {}
+
+    [[nodiscard]] Value read() {
+        skip_whitespace();
+        auto result = read_value();
+        skip_whitespace();
+
+        if (m_at != m_end) {
+            error("unexpected character after the top-level value");
+        }
+
+        return result;
+    }
+
+private:
+    [[noreturn]] void error(const std::string& description) const {
+        Position position;
+        position.offset = static_cast<std::uint32_t>(m_at - m_source.data());
+
+        position = LineIndex{m_source}.resolve(position);
+
+        throw ParseError{description, m_filename, {position, position}};
+    }
+
+    [[nodiscard]] bool at_end() const noexcept { return m_at == m_end; }
+
+    [[nodiscard]] std::size_t remaining() const noexcept {
+        return static_cast<std::size_t>(m_end - m_at);
+    }
+
+    void skip_whitespace() noexcept {
+        while (!at_end() && (*m_at == ' ' || *m_at == '\n' || *m_at == '\t' ||
+                             *m_at == '\r')) {
+            ++m_at;
+        }
+    }
+
+    void expect(char character) {
+        if (at_end() || *m_at != character) {
+            error(std::string{"expected '"} + character + "'");
+        }
+
+        ++m_at;
+    }
+
+    void expect(std::string_view word) {
+        if (std::string_view{m_at, remaining()}.substr(0, word.size()) !=
+            word) {
+            error("unexpected character");
+        }
+
+        m_at += word.size();
+    }
+
+    // Nesting is tracked on an explicit stack instead of by recursion, so
+    // deep input cannot overflow the call stack.
+    [[nodiscard]] Value read_value() {
+        while (true) {
+            skip_whitespace();
+
+            if (at_end()) {
+                error("unexpected end of input; expected a value");
+            }
+
+            Value value;
+
+            if (*m_at == '{' || *m_at == '[') {
+                auto closer = *m_at == '{' ? '}' : ']';
+
+                open(*m_at == '{');
+                skip_whitespace();
+
+                if (at_end() || *m_at != closer) {
+                    if (top().is_object) {
+                        read_key();
+                    }
+
+                    continue;
+                }
+
+                ++m_at;
+                value = close();
+            } else {
+                value = read_scalar();
+            }
+
+            // Adds the value to the enclosing containers and closes those
+            // that end after it.
+            while (true) {
+                if (m_depth == 0) {
+                    return value;
+                }
+
+                add(std::move(value));
+                skip_whitespace();
+
+                if (!at_end() && *m_at == ',') {
+                    ++m_at;
+
+                    if (top().is_object) {
+                        read_key();
+                    }
+
+                    break;
+                }
+
+                expect(top().is_object ? '}' : ']');
+                value = close();
+            }
+        }
+    }
+
+    [[nodiscard]] Value read_scalar() {
+        switch (*m_at) {
+        case '"':
+            return read_string();
+        case 't':
+            expect("true");
+            return true;
+        case 'f':
+            expect("false");
+            return false;
+        case 'n':
+            expect("null");
+            return {};
+        default:
+            return read_number();
+        }
+    }
+
+    void read_key() {
+        skip_whitespace();
+
+        if (at_end() || *m_at != '"') {
+            error("expected a key");
+        }
+
+        top().key = read_string();
+
+        skip_whitespace();
+        expect(':');
+    }
+
+    struct Frame {
+        bool is_object = false;
+
+        Object object;
+        std::string key;
+
+        Array array;
+
+        // Homogeneous scalar arrays are packed like in lumen documents.
+        PackedArray packed;
+        bool is_packed = true;
+    };
+
+    [[nodiscard]] Frame& top() noexcept { return m_stack[m_depth - 1]; }
+
+    void open(bool is_object) {
+        if (m_depth >= m_max_depth) {
+            error(
+                "nesting is deeper than " + std::to_string(m_max_depth) +
+                " levels");
+        }
+
+        ++m_at;
+
+        if (m_depth == m_stack.size()) {
+            m_stack.emplace_back();
+        }
+
+        auto& frame = m_stack[m_depth++];
+
+        frame.is_object = is_object;
+        frame.is_packed = true;
+    }
+
+    void add(Value&& value) {
+        auto& frame = top();
+
+        if (frame.is_object) {
+            frame.object.insert_or_assign(
+                std::move(frame.key), std::move(value));
+            return;
+        }
+
+        if (frame.is_packed && !frame.packed.push_back(value)) {
+            frame.array = frame.packed.unpack();
+            frame.packed.clear();
+            frame.is_packed = false;
+        }
+
+        if (!frame.is_packed) {
+            frame.array.push_back(std::move(value));
+        }
+    }
+
+    [[nodiscard]] Value close() {
+        auto& frame = top();
+        --m_depth;
+
+        if (frame.is_object) {
+            Value result{std::move(frame.object)};
+            frame.object.clear();
+
+            return result;
+        }
+
+        if (frame.is_packed && !frame.packed.empty()) {
+            frame.packed.shrink_to_fit();
+
+            Value result{std::move(frame.packed)};
+            frame.packed.clear();
+
+            return result;
+        }
+
+        Value result{std::move(frame.array)};
+        frame.array.clear();
+
+        return result;
+    }
+
+    // Skips to the first quote, backslash, control character or non-ASCII
+    // byte.
+    void skip_plain_characters() noexcept {
+        if constexpr (details::swar::enabled) {
+            while (remaining() >= 8) {
+                auto chunk = details::swar::load(m_at);
+                auto special = details::swar::equal(chunk, '"') |
+                               details::swar::equal(chunk, '\\') |
+                               details::swar::less(chunk, 0x20) |
+                               (chunk & details::swar::high_bits);
+
+                if (special != 0) {
+                    m_at += std::countr_zero(special) / 8;
+                    return;
+                }
+
+                m_at += 8;
+            }
+        }
+
+        while (!at_end() && *m_at != '"' && *m_at != '\\' &&
+               static_cast<unsigned char>(*m_at) >= 0x20 &&
+               static_cast<unsigned char>(*m_at) < 0x80) {
+            ++m_at;
+        }
+    }
+
+    [[nodiscard]] std::string read_string() {
+        ++m_at;
+
+        std::string result;
+
+        while (true) {
+            auto* begin = m_at;
+            skip_plain_characters();
+            result.append(begin, m_at);
+
+            if (at_end()) {
+                error("unterminated string");
+            }
+
+            if (*m_at == '"') {
+                ++m_at;
+                return result;
+            }
+
+            if (*m_at == '\\') {
+                ++m_at;
+                read_escape(result);
+            } else if (static_cast<unsigned char>(*m_at) < 0x80) {
+                error("control character in a string");
+            } else {
+                read_utf8_sequence(result);
+            }
+        }
+    }
+
+    void read_escape(std::string& output) {
+        if (at_end()) {
+            error("unterminated string");
+        }
+
+        switch (*m_at++) {
+        case '"':
+            output += '"';
+            return;
+        case '\\':
+            output += '\\';
+            return;
+        case '/':
+            output += '/';
+            return;
+        case 'b':
+            output += '\b';
+            return;
+        case 'f':
+            output += '\f';
+            return;
+        case 'n':
+            output += '\n';
+            return;
+        case 'r':
+            output += '\r';
+            return;
+        case 't':
+            output += '\t';
+            return;
+        case 'u':
+            break;
+        default:
+            --m_at;
+            error("invalid escape sequence");
+        }
+
+        auto code_point = read_code_unit();
+
+        if (code_point >= 0xd800 && code_point < 0xdc00) {
+            if (!std::string_view{m_at, remaining()}.starts_with("\\u")) {
+                error("invalid surrogate pair");
+            }
+
+            m_at += 2;
+
+            auto low = read_code_unit();
+
+            if (low < 0xdc00 || low >= 0xe000) {
+                error("invalid surrogate pair");
+            }
+
+            code_point = 0x10000 + ((code_point - 0xd800) << 10) +
+                         (low - 0xdc00);
+        } else if (code_point >= 0xdc00 && code_point < 0xe000) {
+            error("invalid surrogate pair");
+        }
+
+        details::utf8::append(output, code_point);
+    }
+
+    [[nodiscard]] std::uint32_t read_code_unit() {
+        std::uint32_t result = 0;
+
+        if (remaining() < 4 ||
+            std::from_chars(m_at, m_at + 4, result, 16).ptr != m_at + 4) {
+            error("invalid unicode escape sequence");
+        }
+
+        m_at += 4;
+
+        return result;
+    }
+
+    void read_utf8_sequence(std::string& output) {
+        auto length = details::utf8::sequence_length(*m_at);
+        auto [low, high] = details::utf8::second_byte_range(*m_at);
+
+        if (length == 0 || remaining() < length) {
+            error("invalid UTF-8");
+        }
+
+        for (std::size_t i = 1; i < length; ++i) {
+            auto byte = static_cast<unsigned char>(m_at[i]);
+
+            if (byte < low || byte > high) {
+                error("invalid UTF-8");
+            }
+
+            low = 0x80;
+            high = 0xbf;
+        }
+
+        output.append(m_at, length);
+        m_at += length;
+    }
+
+    void skip_digits() noexcept {
+        if constexpr (details::swar::enabled) {
+            while (remaining() >= 8) {
+                auto count = details::swar::count_digits<10>(m_at);
+                m_at += count;
+
+                if (count < 8) {
+                    return;
+                }
+            }
+        }
+
+        while (!at_end() && *m_at >= '0' && *m_at <= '9') {
+            ++m_at;
+        }
+    }
+
+    [[nodiscard]] bool skip_digits_at_least_one() noexcept {
+        auto* begin = m_at;
+        skip_digits();
+
+        return m_at != begin;
+    }
+
+    [[nodiscard]] Value read_number() {
+        auto* begin = m_at;
+        bool is_negative = *m_at == '-';
+
+        if (is_negative) {
+            ++m_at;
+        }
+
+        auto* digits = m_at;
+
+        if (!at_end() && *m_at == '0') {
+            ++m_at;
+        } else if (!skip_digits_at_least_one()) {
+            error("unexpected character; expected a value");
+        }
+
+        auto* digits_end = m_at;
+        bool is_float = false;
+
+        if (!at_end() && *m_at == '.') {
+            ++m_at;
+            is_float = true;
+
+            if (!skip_digits_at_least_one()) {
+                error("expected a digit after the decimal point");
+            }
+        }
+
+        if (!at_end() && (*m_at == 'e' || *m_at == 'E')) {
+            ++m_at;
+            is_float = true;
+
+            if (!at_end() && (*m_at == '+' || *m_at == '-')) {
+                ++m_at;
+            }
+
+            if (!skip_digits_at_least_one()) {
+                error("expected a digit in the exponent");
+            }
+        }
+
+        std::string_view number{begin, static_cast<std::size_t>(m_at - begin)};
+
+        if (is_float) {
+            Float result{};
+            auto [end, status] = std::from_chars(begin, m_at, result);
+
+            if (status == std::errc::result_out_of_range) {
+                m_at = begin;
+                error("float '" + std::string{number} + "' is out of range");
+            }
+
+            return result;
+        }
+
+        auto magnitude = details::swar::parse_unsigned<10>(
+            {digits, static_cast<std::size_t>(digits_end - digits)});
+
+        if (!is_negative && magnitude.has_value()) {
+            return *magnitude;
+        }
+
+        constexpr auto limit =
+            static_cast<UInt>(std::numeric_limits<Int>::max()) + 1;
+
+        if (!magnitude.has_value() || *magnitude > limit) {
+            m_at = begin;
+            error("integer '" + std::string{number} + "' is out of range");
+        }
+
+        return static_cast<Int>(0 - *magnitude);
+    }
+
+    std::string_view m_source;
+    std::string m_filename;
+
+    const char* m_at;
+    const char* m_end;
+
+    // Frames past the current depth are kept to be reused.
+    std::vector<Frame> m_stack;
+    std::size_t m_depth = 0;
+    std::size_t m_max_depth;
+};
+
+class JsonWriter {
+public:
+    [[nodiscard]] JsonWriter(std::string& output, std::size_t indent) noexcept
+    : m_output{output}, m_indent{indent} {}
+
+    void write(const Value& value) {
+        switch (value.get_type()) {
+        case Value::Type::UInt:
+            write_number(value.get_strict<UInt>());
+            return;
+        case Value::Type::Int:
+            write_number(value.get_strict<Int>());
+            return;
+        case Value::Type::Float:
+            write_number(value.get_strict<Float>());
+            return;
+        case Value::Type::Bool:
+            write_number(value.get_strict<Bool>());
+            return;
+        case Value::Type::String:
+            write_string(value.get_strict<String>());
+            return;
+        case Value::Type::Array:
+            if (value.is<PackedArray>()) {
+                value.get_strict<PackedArray>().visit([this](auto elements) {
+                    write_array(elements, [this](auto element) {
+                        write_number(element);
+                    });
+                });
+            } else {
+                write_array(
+                    value.get_strict<Array>(),
+                    [this](const Value& element) { write(element); });
+            }
+
+            return;
+        case Value::Type::Object:
+            write(value.get_strict<Object>());
+            return;
+        case Value::Type::Undefined:
+            m_output += "null";
+            return;
+        }
+    }
+
+    void write(const Object& object) {
+        if (object.empty()) {
+            m_output += "{}";
+            return;
+        }
+
+        m_output += '{';
+        ++m_depth;
+
+        bool is_first = true;
+
+        for (const auto& [key, value] : object) {
+            if (!is_first) {
+                m_output += ',';
+            }
+
+            is_first = false;
+
+            write_line_break();
+            write_string(key);
+            m_output += m_indent == 0 ? ":" : ": ";
+            write(value);
+        }
+
+        --m_depth;
+        write_line_break();
+        m_output += '}';
+    }
+
+private:
+    void write_line_break() {
+        if (m_indent != 0) {
+            m_output += '\n';
+            m_output.append(m_depth * m_indent, ' ');
+        }
+    }
+
+    void write_array(const auto& elements, const auto& write_element) {
+        if (elements.empty()) {
+            m_output += "[]";
+            return;
+        }
+
+        m_output += '[';
+        ++m_depth;
+
+        bool is_first = true;
+
+        for (const auto& element : elements) {
+            if (!is_first) {
+                m_output += ',';
+            }
+
+            is_first = false;
+
+            write_line_break();
+            write_element(element);
+        }
+
+        --m_depth;
+        write_line_break();
+        m_output += ']';
+    }
+
+    void write_number(Bool value) { m_output += value ? "true" : "false"; }
+
+    void write_number(auto value) {
+        if constexpr (std::is_floating_point_v<decltype(value)>) {
+            if (!std::isfinite(value)) {
+                m_output += "null";
+                return;
+            }
+        }
+
+        std::array<char, 32> buffer{};
+        auto end =
+            std::to_chars(buffer.data(), buffer.data() + buffer.size(), value)
+                .ptr;
+
+        std::string_view number{
+            buffer.data(), static_cast<std::size_t>(end - buffer.data())};
+        m_output += number;
+
+        // Keeps integral floats floats when they are read back.
+        if (std::is_floating_point_v<decltype(value)> &&
+            number.find_first_of(".en") == std::string_view::npos) {
+            m_output += ".0";
+        }
+    }
+
+    void write_string(std::string_view string) {
+        m_output += '"';
+
+        while (!string.empty()) {
+            auto plain = plain_prefix(string);
+
+            m_output += string.substr(0, plain);
+            string.remove_prefix(plain);
+
+            if (string.empty()) {
+                break;
+            }
+
+            write_escape(string.front());
+            string.remove_prefix(1);
+        }
+
+        m_output += '"';
+    }
+
+    // Returns the length of the prefix that needs no escaping.
+    [[nodiscard]] static std::size_t
+    plain_prefix(std::string_view string) noexcept {
+        std::size_t at = 0;
+
+        if constexpr (details::swar::enabled) {
+            for (; string.size() - at >= 8; at += 8) {
+                auto chunk = details::swar::load(&string[at]);
+                auto special = details::swar::equal(chunk, '"') |
+                               details::swar::equal(chunk, '\\') |
+                               details::swar::less(chunk, 0x20);
+
+                if (special != 0) {
+                    return at + std::countr_zero(special) / 8;
+                }
+            }
+        }
+
+        while (at < string.size() && string[at] != '"' && string[at] != '\\' &&
+               static_cast<unsigned char>(string[at]) >= 0x20) {
+            ++at;
+        }
+
+        return at;
+    }
+
+    void write_escape(char character) {
+        switch (character) {
+        case '"':
+            m_output += "\\\"";
+            return;
+        case '\\':
+            m_output += "\\\\";
+            return;
+        case '\b':
+            m_output += "\\b";
+            return;
+        case '\f':
+            m_output += "\\f";
+            return;
+        case '\n':
+            m_output += "\\n";
+            return;
+        case '\r':
+            m_output += "\\r";
+            return;
+        case '\t':
+            m_output += "\\t";
+            return;
+        default:
+            constexpr std::string_view digits = "0123456789abcdef";
+
+            m_output += "\\u00";
+            m_output += digits[static_cast<unsigned char>(character) >> 4];
+            m_output += digits[static_cast<unsigned char>(character) & 0xf];
+        }
+    }
+
+    std::string& m_output;
+
+    std::size_t m_indent;
+    std::size_t m_depth = 0;
+};
+
+} // namespace
+
+Value parse_json_value(
+    std::string_view source, const std::string& filename,
+    const ParseOptions& options) {
+    return JsonReader{source, filename, options.max_depth}.read();
+}
+
+Document parse_json(
+    std::string_view source, const std::string& filename,
+    const ParseOptions& options) {
+    auto result = parse_json_value(source, filename, options);
+
+    if (!result.is<Object>()) {
+        throw ParseError{
+            "the top-level JSON value must be an object", filename, {}};
+    }
+
+    return std::move(result).get<Object>();
+}
+
+void write_json(const Value& value, std::string& output, std::size_t indent) {
+    JsonWriter{output, indent}.write(value);
+}
+
+void write_json(const Object& object, std::string& output, std::size_t indent) {
+    JsonWriter{output, indent}.write(object);
+}
+
+} // namespace lumen
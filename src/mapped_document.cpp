@@ -0,0 +1,233 @@
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/lumencpp/exceptions.h"
+#include "../include/lumencpp/mapped_document.h"
+
+namespace lumen {
+
+namespace {
+
+static_assert(std::is_trivially_copyable_v<details::FlatNode>);
+
+// Written byte for byte, so identical documents must make identical files.
+static_assert(std::has_unique_object_representations_v<details::FlatNode>);
+
+struct Header {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+
+    // Written as is, so it reads back differently on a machine of the other
+    // byte order.
+    std::uint32_t byte_order;
+
+    std::uint64_t node_count;
+    std::uint64_t strings_size;
+};
+
+constexpr std::array<char, 8> magic{'l', 'u', 'm', 'e', 'n', 'd', 'o', 'c'};
+constexpr std::uint32_t version = 1;
+constexpr std::uint32_t byte_order = 0x01020304;
+
+// The header keeps the node table aligned.
+static_assert(sizeof(Header) % alignof(details::FlatNode) == 0);
+static_assert(std::has_unique_object_representations_v<Header>);
+
+constexpr details::FlatNode empty_root{Value::Type::Object};
+
+[[nodiscard]] bool is_valid(
+    std::span<const details::FlatNode> nodes, std::size_t strings_size) {
+    auto fits = [](std::uint64_t offset, std::uint64_t size,
+                   std::uint64_t limit) {
+        return offset <= limit && size <= limit - offset;
+    };
+
+    if (nodes.empty() || nodes.front().type != Value::Type::Object) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const auto& node = nodes[i];
+
+        if (!fits(node.key_offset, node.key_size, strings_size)) {
+            return false;
+        }
+
+        switch (node.type) {
+        case Value::Type::Undefined:
+        case Value::Type::UInt:
+        case Value::Type::Int:
+        case Value::Type::Float:
+        case Value::Type::Bool:
+            break;
+        case Value::Type::String:
+            if (!fits(node.payload, node.size, strings_size)) {
+                return false;
+            }
+
+            break;
+        case Value::Type::Array:
+        case Value::Type::Object:
+            // Children always follow their parent, which also rules out
+            // cycles.
+            if (node.size > 0 &&
+                (node.payload <= i ||
+                 !fits(node.payload, node.size, nodes.size()))) {
+                return false;
+            }
+
+            break;
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+MappedDocument::MappedDocument() noexcept : m_nodes{&empty_root, 1} {}
+
+MappedDocument::MappedDocument(MappedDocument&& other) noexcept
+: m_data{std::exchange(other.m_data, nullptr)},
+  m_size{std::exchange(other.m_size, 0)},
+  m_nodes{std::exchange(other.m_nodes, {&empty_root, 1})},
+  m_strings{std::exchange(other.m_strings, {})} {}
+
+MappedDocument& MappedDocument::operator=(MappedDocument&& other) noexcept {
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_nodes, other.m_nodes);
+    std::swap(m_strings, other.m_strings);
+
+    return *this;
+}
+
+MappedDocument::~MappedDocument() {
+    if (m_data != nullptr) {
+        ::munmap(m_data, m_size);
+    }
+}
+
+void MappedDocument::write(
+    const FrozenDocument& document, const std::filesystem::path& path) {
+    auto nodes = document.nodes();
+    auto strings = document.strings();
+
+    Header header{magic, version, byte_order, nodes.size(), strings.size()};
+
+    // Unique to the call, so that concurrent writes of the same path each
+    // replace it whole.
+    static std::atomic<std::uint64_t> write_count = 0;
+
+    auto temporary = path;
+    temporary += ".tmp" + std::to_string(::getpid()) + "." +
+                 std::to_string(write_count++);
+
+    {
+        std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(
+            reinterpret_cast<const char*>(nodes.data()),
+            static_cast<std::streamsize>(nodes.size_bytes()));
+        file.write(
+            strings.data(), static_cast<std::streamsize>(strings.size()));
+
+        if (!file.flush()) {
+            std::filesystem::remove(temporary);
+            throw IOError{"unable to write '" + temporary.string() + "'"};
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+
+    if (error) {
+        std::filesystem::remove(temporary);
+        throw IOError{"unable to replace '" + path.string() + "'"};
+    }
+}
+
+MappedDocument MappedDocument::open(const std::filesystem::path& path) {
+    auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (file < 0) {
+        throw IOError{"unable to open '" + path.string() + "'"};
+    }
+
+    struct stat status {};
+
+    if (::fstat(file, &status) != 0) {
+        ::close(file);
+        throw IOError{"unable to stat '" + path.string() + "'"};
+    }
+
+    auto size = static_cast<std::size_t>(status.st_size);
+
+    if (size < sizeof(Header)) {
+        ::close(file);
+        throw IOError{"'" + path.string() + "' is not a lumen document"};
+    }
+
+    auto* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+
+    if (data == MAP_FAILED) {
+        throw IOError{"unable to map '" + path.string() + "'"};
+    }
+
+    MappedDocument result;
+    result.m_data = data;
+    result.m_size = size;
+
+    Header header{};
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic != magic || header.version != version ||
+        header.byte_order != byte_order) {
+        throw IOError{"'" + path.string() + "' is not a lumen document"};
+    }
+
+    auto available = size - sizeof(Header);
+    auto node_limit = available / sizeof(details::FlatNode);
+
+    if (header.node_count > node_limit ||
+        header.strings_size !=
+            available - header.node_count * sizeof(details::FlatNode)) {
+        throw IOError{"'" + path.string() + "' is truncated"};
+    }
+
+    const auto* bytes = static_cast<const char*>(data) + sizeof(Header);
+
+    std::span nodes{
+        reinterpret_cast<const details::FlatNode*>(bytes),
+        static_cast<std::size_t>(header.node_count)};
+    std::string_view strings{
+        bytes + nodes.size_bytes(),
+        static_cast<std::size_t>(header.strings_size)};
+
+    if (!is_valid(nodes, strings.size())) {
+        throw IOError{"'" + path.string() + "' is corrupted"};
+    }
+
+    result.m_nodes = nodes;
+    result.m_strings = strings;
+
+    return result;
+}
+
+} // namespace lumen
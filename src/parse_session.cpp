@@ -0,0 +1,28 @@
+#include <utility>
+
+#include "../include/lumencpp/parse_session.h"
+
+namespace lumen {
+
+Document ParseSession::parse(
+    std::string_view source, std::string_view filename, Object predefined) {
+    predefined.reserve(m_member_hint);
+
+    auto result = details::parse(
+        m_lexer, m_parser, m_tokens, source, filename, std::move(predefined),
+        m_options);
+
+    m_member_hint = result.data.size();
+
+    return result;
+}
+
+void ParseSession::clear() {
+    m_lexer = Lexer{m_options};
+    m_parser = Parser{m_options};
+    m_tokens = {};
+
+    m_member_hint = 0;
+}
+
+} // namespace lumen
@@ -5,18 +5,73 @@
 namespace lumen {
 
 Object Parser::parse(
-    const std::vector<Token>& tokens, std::string filename, Object predefined) {
-    m_data = std::move(predefined);
+    const std::vector<Token>& tokens, std::string_view filename,
+    Object predefined) {
+    m_profiler.start(PhaseProfile::Phase::Parse, m_options.profile_sink);
+    m_profiler.count_consumed(tokens.size());
 
-    m_filename = std::move(filename);
+    m_filename = filename;
 
     if (!tokens.empty() && tokens.back().type != Token::Type::Eof) {
         throw ParseError{
             "expected an end of file at the end of the input",
-            std::move(m_filename), tokens.back().source};
+            m_filename, tokens.back().source};
     }
 
-    m_at = tokens.begin();
+    m_at = tokens.data();
+    m_end = m_at + tokens.size();
+    m_lexer = nullptr;
+
+    return parse_statements(std::move(predefined));
+}
+
+Object Parser::parse(
+    Lexer& lexer, ChunkReader& reader, std::string_view filename,
+    Object predefined) {
+    m_profiler.start(PhaseProfile::Phase::Parse, m_options.profile_sink);
+
+    m_filename = filename;
+
+    lexer.start(reader, filename);
+
+    auto& batch = m_batches[m_batch];
+    batch.clear();
+    lexer.next(batch, batch_size);
+
+    m_profiler.count_consumed(batch.size());
+
+    m_at = batch.data();
+    m_end = m_at + batch.size();
+    m_lexer = &lexer;
+
+    auto result = parse_statements(std::move(predefined));
+    m_lexer = nullptr;
+
+    return result;
+}
+
+void Parser::next_batch() {
+    m_batch ^= 1;
+
+    auto& batch = m_batches[m_batch];
+    batch.clear();
+    batch.push_back(m_at[-1]);
+    m_lexer->next(batch, batch_size);
+
+    m_profiler.count_consumed(batch.size() - 1);
+
+    m_at = batch.data() + 1;
+    m_end = batch.data() + batch.size();
+}
+
+Object Parser::parse_statements(Object predefined) {
+    m_data = std::move(predefined);
+    m_failed = false;
+
+    // A failed parse leaves its open containers behind.
+    for (; m_depth > 0; --m_depth) {
+        m_stack[m_depth - 1] = {};
+    }
 
     skip_line_breaks();
 
@@ -30,108 +85,225 @@ Object Parser::parse(
 
         parse_assignment(m_data);
 
-        if (at_end()) {
-            break;
+        if (!m_failed && !at_end()) {
+            expect<
+                Token::Type::LineBreak, Token::Type::Semicolon,
+                Token::Type::Eof>();
         }
 
-        expect<
-            Token::Type::LineBreak, Token::Type::Semicolon, Token::Type::Eof>();
+        if (m_failed) {
+            skip_statement();
+        }
 
         skip_line_breaks();
     }
 
+    m_profiler.finish();
+
     return std::move(m_data);
 }
 
-Value& Parser::parse_key_path(
-    Object& parent, const Token& token, bool create_if_not_exist) {
-    auto key = get_token_lexeme(token);
-    auto source = token.source;
+Value& Parser::parse_key_path(Object& parent, const Token& token) {
+    auto* object = &parent;
+    const auto* segment = &token;
 
-    if (!create_if_not_exist &&
-        parent[key].get_type() == Value::Type::Undefined) {
-        throw ParseError{
-            "field '" + key + "' does not exist", std::move(m_filename),
-            source};
-    }
+    while (true) {
+        if (m_failed) {
+            return m_undefined;
+        }
 
-    Value* result = &parent[key];
+        m_profiler.count_key_path_resolution();
+
+        const auto& key = get_token_lexeme(*segment);
+        auto source = segment->source;
+
+        auto size = object->size();
+        Value* result = &(*object)[key];
+
+        m_profiler.count_allocation(object->size() != size);
+
+        if (at().type != Token::Type::Dot) {
+            return *result;
+        }
+
+        // Assigning to a member of an object in the scope copies the object,
+        // so that its other members are kept.
+        if (object == &m_data && m_options.scope != nullptr &&
+            result->get_type() == Value::Type::Undefined) {
+            if (const auto* shadowed = find(*m_options.scope, key)) {
+                *result = *shadowed;
+            }
+        }
 
-    if (at().type == Token::Type::Dot) {
         eat();
 
-        try {
-            return parse_key_path(
-                result->get_strict<Object>(), create_if_not_exist);
-        } catch (const TypeMismatch&) {
-            throw ParseError{
+        if (result->get_type() != Value::Type::Undefined &&
+            result->get_type() != Value::Type::Object) {
+            fail(ParseError{
                 "unable to parse a key path, '" + key +
                     "' was defined and is not an object",
-                std::move(m_filename), source};
+                m_filename, source});
+
+            return *result;
         }
-    }
 
-    return *result;
+        object = &result->get_strict<Object>();
+        segment = &expect<Token::Type::Identifier>();
+    }
 }
 
-Array Parser::parse_array() {
-    Array result;
+const Value& Parser::parse_reference(const Token& token) {
+    const auto* object = &m_data;
+    const auto* segment = &token;
 
     while (true) {
-        skip_line_breaks();
+        if (m_failed) {
+            return m_undefined;
+        }
 
-        if (at_end()) {
-            expect<Token::Type::RightBracket>();
+        m_profiler.count_key_path_resolution();
+
+        const auto& key = get_token_lexeme(*segment);
+        auto source = segment->source;
+
+        const auto* result = find(*object, key);
+
+        if (result == nullptr && object == &m_data &&
+            m_options.scope != nullptr) {
+            result = find(*m_options.scope, key);
         }
 
-        if (at().type == Token::Type::RightBracket) {
-            break;
+        if (result == nullptr) {
+            fail(ParseError{
+                "field '" + key + "' does not exist", m_filename, source});
+
+            return m_undefined;
         }
 
-        result.push_back(parse_value());
+        if (at().type != Token::Type::Dot) {
+            return *result;
+        }
 
-        if (at().type == Token::Type::RightBracket) {
-            break;
+        eat();
+
+        if (!result->is<Object>()) {
+            fail(ParseError{
+                "unable to parse a key path, '" + key +
+                    "' was defined and is not an object",
+                m_filename, source});
+
+            return m_undefined;
         }
 
-        expect<Token::Type::LineBreak, Token::Type::Comma>();
+        object = &result->get_strict<Object>();
+        segment = &expect<Token::Type::Identifier>();
     }
+}
 
-    eat();
+void Parser::open(const Token& token) {
+    if (m_depth >= m_options.max_depth) {
+        // Leaves the bracket for error recovery to skip its contents.
+        --m_at;
 
-    return result;
+        fail(ParseError{
+            "nesting is deeper than " + std::to_string(m_options.max_depth) +
+                " levels",
+            m_filename, token.source});
+
+        return;
+    }
+
+    if (m_depth == m_stack.size()) {
+        m_stack.emplace_back();
+    }
+
+    auto& frame = m_stack[m_depth++];
+
+    frame.is_object = token.type == Token::Type::LeftBrace;
+    frame.is_packed = true;
 }
 
-Object Parser::parse_object() {
-    Object result;
+void Parser::add(Value&& value) {
+    auto& frame = top();
 
-    while (true) {
-        skip_line_breaks();
+    if (frame.is_object) {
+        *frame.target = std::move(value);
+        return;
+    }
+
+    if (frame.is_packed && !frame.packed.push_back(value)) {
+        frame.array = frame.packed.unpack();
+        frame.packed.clear();
+        frame.is_packed = false;
+    }
 
-        if (at_end()) {
+    if (!frame.is_packed) {
+        m_profiler.count_allocation(
+            frame.array.size() == frame.array.capacity());
+        frame.array.push_back(std::move(value));
+    }
+}
+
+// Moves to the next element of the innermost container; returns false if the
+// container ends instead.
+bool Parser::next_element() {
+    auto& frame = top();
+
+    skip_line_breaks();
+
+    if (at_end()) {
+        if (frame.is_object) {
             expect<Token::Type::RightBrace>();
+        } else {
+            expect<Token::Type::RightBracket>();
         }
 
-        if (at().type == Token::Type::RightBrace) {
-            break;
-        }
+        return false;
+    }
 
-        parse_assignment(result);
+    if (at().type == (frame.is_object ? Token::Type::RightBrace
+                                      : Token::Type::RightBracket)) {
+        return false;
+    }
 
-        if (at().type == Token::Type::RightBrace) {
-            break;
+    if (frame.is_object) {
+        frame.target = &parse_key_path(frame.object);
+
+        if (!m_failed) {
+            expect<Token::Type::Equal>();
         }
+    }
 
-        expect<Token::Type::LineBreak, Token::Type::Comma>();
+    return !m_failed;
+}
+
+Value Parser::close() {
+    // A container that error recovery gives up on has no closing bracket.
+    if (at().type == Token::Type::RightBracket ||
+        at().type == Token::Type::RightBrace) {
+        eat();
     }
 
-    eat();
+    auto& frame = m_stack[--m_depth];
 
-    return result;
+    if (frame.is_object) {
+        return std::exchange(frame.object, {});
+    }
+
+    if (frame.is_packed && !frame.packed.empty()) {
+        frame.packed.shrink_to_fit();
+
+        Value result{std::move(frame.packed)};
+        frame.packed.clear();
+
+        return result;
+    }
+
+    return std::exchange(frame.array, {});
 }
 
 Value Parser::parse_integer(const Token& token) {
-    auto number = get_token_lexeme(token);
+    const auto& number = get_token_lexeme(token);
 
     if (number.starts_with('-')) {
         return from_string<Int>(token.source, number);
@@ -140,36 +312,194 @@ Value Parser::parse_integer(const Token& token) {
     return from_string<UInt>(token.source, number);
 }
 
-Value Parser::parse_value() {
-    auto token = expect<
-        Token::Type::LeftBracket, Token::Type::LeftBrace,
-        Token::Type::Identifier, Token::Type::Integer, Token::Type::Boolean,
-        Token::Type::Float, Token::Type::String>();
-
+Value Parser::parse_scalar(const Token& token) {
     switch (token.type) {
-    case Token::Type::LeftBracket:
-        return parse_array();
-    case Token::Type::LeftBrace:
-        return parse_object();
     case Token::Type::Identifier:
-        return parse_key_path(m_data, token, false);
+        return parse_reference(token);
     case Token::Type::Integer:
         return parse_integer(token);
     case Token::Type::Boolean:
         return get_token_lexeme(token) == "true";
     case Token::Type::Float:
         return from_string<Float>(token.source, get_token_lexeme(token));
-    case Token::Type::String:
-        return get_token_lexeme(token);
+    case Token::Type::String: {
+        auto string = get_token_lexeme(token);
+        bool is_allocated = string.capacity() > std::string{}.capacity();
+        m_profiler.count_allocation(is_allocated);
+
+        // Sharing a string that needs no allocation saves nothing.
+        if (m_options.string_pool != nullptr && is_allocated) {
+            return m_options.string_pool->intern(std::move(string));
+        }
+
+        return string;
+    }
     default:
         return {};
     }
 }
 
+Value Parser::parse_value() {
+    auto bottom = m_depth;
+
+    while (true) {
+        const auto& token = expect<
+            Token::Type::LeftBracket, Token::Type::LeftBrace,
+            Token::Type::Identifier, Token::Type::Integer,
+            Token::Type::Boolean, Token::Type::Float, Token::Type::String>();
+
+        bool is_container = token.type == Token::Type::LeftBracket ||
+                            token.type == Token::Type::LeftBrace;
+
+        Value result;
+
+        if (m_failed) {
+            // Dropped; the chain below recovers.
+        } else if (is_container) {
+            open(token);
+
+            if (!m_failed && next_element()) {
+                continue;
+            }
+
+            if (!m_failed) {
+                result = close();
+            }
+        } else {
+            result = parse_scalar(token);
+        }
+
+        // Hands finished values to their containers and closes the containers
+        // that end, until one expects another element.
+        while (m_depth != bottom) {
+            auto closing = top().is_object ? Token::Type::RightBrace
+                                           : Token::Type::RightBracket;
+
+            if (!m_failed) {
+                add(std::move(result));
+
+                if (at().type != closing) {
+                    expect<Token::Type::LineBreak, Token::Type::Comma>();
+                }
+
+                if (!m_failed && next_element()) {
+                    break;
+                }
+            }
+
+            if (m_failed && recover()) {
+                break;
+            }
+
+            result = close();
+        }
+
+        if (m_depth == bottom) {
+            return result;
+        }
+    }
+}
+
+// Skips tokens up to the next separator, closing bracket or statement end
+// that is not nested in brackets being skipped.
+void Parser::skip_to_boundary() {
+    std::size_t nesting = 0;
+
+    while (true) {
+        switch (at().type) {
+        case Token::Type::Semicolon:
+        case Token::Type::Eof:
+            return;
+        case Token::Type::Comma:
+        case Token::Type::LineBreak:
+            if (nesting == 0) {
+                return;
+            }
+
+            break;
+        case Token::Type::LeftBracket:
+        case Token::Type::LeftBrace:
+            ++nesting;
+            break;
+        case Token::Type::RightBracket:
+        case Token::Type::RightBrace:
+            if (nesting == 0) {
+                return;
+            }
+
+            --nesting;
+            break;
+        default:
+            break;
+        }
+
+        eat();
+    }
+}
+
+// Resumes the innermost container after an error; returns true at its next
+// element and false where it ends. The error stays set if the statement ends
+// first, so that the enclosing containers close without reporting more.
+bool Parser::recover() {
+    while (true) {
+        skip_to_boundary();
+
+        switch (at().type) {
+        case Token::Type::Comma:
+        case Token::Type::LineBreak:
+            m_failed = false;
+            eat();
+
+            if (next_element()) {
+                return true;
+            }
+
+            if (!m_failed) {
+                return false;
+            }
+
+            break;
+        case Token::Type::RightBracket:
+        case Token::Type::RightBrace:
+            m_failed = false;
+            return false;
+        default:
+            return false;
+        }
+    }
+}
+
+void Parser::skip_statement() {
+    m_failed = false;
+
+    while (true) {
+        skip_to_boundary();
+
+        auto type = at().type;
+
+        if (type == Token::Type::Eof) {
+            return;
+        }
+
+        eat();
+
+        if (type == Token::Type::LineBreak ||
+            type == Token::Type::Semicolon) {
+            return;
+        }
+    }
+}
+
 void Parser::parse_assignment(Object& parent) {
     auto& key = parse_key_path(parent);
-    expect<Token::Type::Equal>();
-    key = parse_value();
+
+    if (!m_failed) {
+        expect<Token::Type::Equal>();
+    }
+
+    if (!m_failed) {
+        key = parse_value();
+    }
 }
 
 } // namespace lumen
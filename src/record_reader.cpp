@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../include/lumencpp/exceptions.h"
+#include "../include/lumencpp/record_reader.h"
+#include "../include/lumencpp/swar.h"
+
+namespace lumen {
+
+namespace {
+
+// Returns the position of the first line break followed by a dash at or after
+// `at`, or npos.
+[[nodiscard]] std::size_t
+find_dash_line(std::string_view data, std::size_t at) noexcept {
+    namespace swar = details::swar;
+
+    if constexpr (swar::enabled) {
+        while (data.size() - at > 8) {
+            auto candidates = swar::equal(swar::load(&data[at]), '\n') &
+                              swar::equal(swar::load(&data[at + 1]), '-');
+
+            if (candidates == 0) {
+                at += 8;
+                continue;
+            }
+
+            // Only the lowest flagged byte of each mask is exact.
+            auto found = at + static_cast<std::size_t>(
+                                  std::countr_zero(candidates) / 8);
+
+            if (data[found] == '\n' && data[found + 1] == '-') {
+                return found;
+            }
+
+            at = found + 1;
+        }
+    }
+
+    return data.find("\n-", at);
+}
+
+} // namespace
+
+RecordReader::RecordReader(const std::filesystem::path& path, Options options)
+: m_options{options}, m_filename{path.string()},
+  m_session{options.parse_options} {
+    m_options.index_interval = std::max<std::size_t>(options.index_interval, 1);
+    m_options.chunk_size = std::max<std::size_t>(options.chunk_size, 1);
+
+    m_file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (m_file < 0) {
+        throw IOError{"unable to open '" + m_filename + "'"};
+    }
+}
+
+RecordReader::RecordReader(std::istream& stream, Options options)
+: m_options{options}, m_stream{&stream}, m_filename{"<stream>"},
+  m_session{options.parse_options} {
+    m_options.index_interval = std::max<std::size_t>(options.index_interval, 1);
+    m_options.chunk_size = std::max<std::size_t>(options.chunk_size, 1);
+}
+
+RecordReader::~RecordReader() {
+    if (m_file >= 0) {
+        ::close(m_file);
+    }
+}
+
+std::optional<Document> RecordReader::next() {
+    auto record = read_record();
+
+    if (!record.has_value()) {
+        return std::nullopt;
+    }
+
+    auto* diagnostics = m_options.parse_options.diagnostics;
+    auto reported = diagnostics != nullptr ? diagnostics->size() : 0;
+
+    // Positions are counted from the start of the record.
+    auto name_record = [this](ParseError& error) {
+        error.filename += " (record " + std::to_string(m_record - 1) + ")";
+    };
+
+    try {
+        auto result = m_session.parse(*record, m_filename);
+
+        if (diagnostics != nullptr) {
+            for (auto i = reported; i < diagnostics->size(); ++i) {
+                name_record((*diagnostics)[i]);
+            }
+        }
+
+        return result;
+    } catch (ParseError& error) {
+        name_record(error);
+        throw;
+    }
+}
+
+bool RecordReader::skip() { return read_record().has_value(); }
+
+void RecordReader::seek(std::uint64_t record) {
+    auto interval = m_options.index_interval;
+
+    std::uint64_t start = 0;
+    std::uint64_t offset = 0;
+
+    if (!m_index.empty()) {
+        auto slot =
+            std::min<std::uint64_t>(record / interval, m_index.size() - 1);
+
+        start = slot * interval;
+        offset = m_index[slot];
+    }
+
+    if (record < m_record || start > m_record) {
+        if (m_stream != nullptr) {
+            if (record < m_record) {
+                throw IOError{"unable to seek backwards in a stream"};
+            }
+        } else {
+            if (::lseek(m_file, static_cast<off_t>(offset), SEEK_SET) < 0) {
+                throw IOError{"unable to seek in '" + m_filename + "'"};
+            }
+
+            m_begin = 0;
+            m_end = 0;
+            m_is_exhausted = false;
+
+            m_record = start;
+            m_offset = offset;
+        }
+    }
+
+    while (m_record < record && skip()) {
+    }
+}
+
+std::optional<std::string_view> RecordReader::read_record() {
+    std::size_t from = 0;
+
+    while (true) {
+        auto [position, length] = find_separator(from);
+
+        if (length == 0 && !m_is_exhausted) {
+            from = position;
+            fill();
+
+            continue;
+        }
+
+        if (length == 0) {
+            position = m_end - m_begin;
+        }
+
+        if (position == 0) {
+            if (length == 0) {
+                return std::nullopt;
+            }
+
+            consume(length);
+            from = 0;
+
+            continue;
+        }
+
+        auto interval = m_options.index_interval;
+
+        if (m_record % interval == 0 && m_record / interval == m_index.size()) {
+            m_index.push_back(m_offset);
+        }
+
+        std::string_view result{m_buffer.data() + m_begin, position};
+
+        consume(position + length);
+        ++m_record;
+
+        return result;
+    }
+}
+
+std::pair<std::size_t, std::size_t>
+RecordReader::find_separator(std::size_t from) const noexcept {
+    constexpr auto more = std::string_view::npos;
+
+    std::string_view data{m_buffer.data() + m_begin, m_end - m_begin};
+
+    // Returns the length of the separator line at `line`, zero if there is
+    // none, or `more` if that depends on input not read yet.
+    auto separator_at = [&](std::size_t line) -> std::size_t {
+        auto rest = data.substr(line);
+
+        if (rest.size() <= separator.size()) {
+            if (rest == separator && m_is_exhausted) {
+                return rest.size();
+            }
+
+            return separator.starts_with(rest) && !m_is_exhausted ? more : 0;
+        }
+
+        if (!rest.starts_with(separator)) {
+            return 0;
+        }
+
+        rest.remove_prefix(separator.size());
+
+        if (rest.front() == '\n') {
+            return separator.size() + 1;
+        }
+
+        if (rest.front() != '\r') {
+            return 0;
+        }
+
+        if (rest.size() == 1) {
+            return m_is_exhausted ? separator.size() + 1 : more;
+        }
+
+        return rest[1] == '\n' ? separator.size() + 2 : 0;
+    };
+
+    // Records start at the beginning of a line.
+    if (from == 0) {
+        auto length = separator_at(0);
+
+        if (length == more) {
+            return {0, 0};
+        }
+
+        if (length > 0) {
+            return {0, length};
+        }
+    }
+
+    for (auto at = from;;) {
+        auto found = find_dash_line(data, at);
+
+        if (found == std::string_view::npos) {
+            // Leaves room for a line break that the next read completes into
+            // a separator.
+            auto tail = data.empty() ? 0 : data.size() - 1;
+
+            return {std::max(from, tail), 0};
+        }
+
+        auto length = separator_at(found + 1);
+
+        if (length == more) {
+            return {found, 0};
+        }
+
+        if (length > 0) {
+            return {found + 1, length};
+        }
+
+        at = found + 1;
+    }
+}
+
+bool RecordReader::fill() {
+    // Moves the part of the record read so far to the front, so the buffer
+    // only grows to fit the largest record.
+    if (m_begin > 0) {
+        std::memmove(
+            m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+
+        m_end -= m_begin;
+        m_begin = 0;
+    }
+
+    auto chunk_size = m_options.chunk_size;
+
+    if (m_buffer.size() - m_end < chunk_size) {
+        m_buffer.resize(m_end + chunk_size);
+    }
+
+    auto* buffer = m_buffer.data() + m_end;
+    std::size_t size = 0;
+
+    if (m_stream != nullptr) {
+        m_stream->read(buffer, static_cast<std::streamsize>(chunk_size));
+
+        if (m_stream->bad()) {
+            throw IOError{"failed to read from a stream"};
+        }
+
+        size = static_cast<std::size_t>(m_stream->gcount());
+    } else {
+        while (true) {
+            auto result = ::read(m_file, buffer, chunk_size);
+
+            if (result >= 0) {
+                size = static_cast<std::size_t>(result);
+                break;
+            }
+
+            if (errno != EINTR) {
+                throw IOError{
+                    "failed to read '" + m_filename +
+                    "': " + std::strerror(errno)};
+            }
+        }
+    }
+
+    m_end += size;
+    m_is_exhausted = size == 0;
+
+    return !m_is_exhausted;
+}
+
+void RecordReader::consume(std::size_t size) noexcept {
+    m_begin += size;
+    m_offset += size;
+}
+
+} // namespace lumen
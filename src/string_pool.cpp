@@ -0,0 +1,24 @@
+#include <memory>
+#include <utility>
+
+#include "../include/lumencpp/string_pool.h"
+
+namespace lumen {
+
+SharedString StringPool::intern(String string) {
+    ++m_stats.strings;
+
+    if (auto found = m_strings.find(string); found != m_strings.end()) {
+        ++m_stats.deduplicated;
+        m_stats.bytes_saved += string.size();
+
+        return found->second;
+    }
+
+    auto shared = std::make_shared<const String>(std::move(string));
+    m_strings.emplace(*shared, shared);
+
+    return shared;
+}
+
+} // namespace lumen
@@ -0,0 +1,743 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "../include/lumencpp/validator.h"
+
+namespace lumen {
+
+namespace {
+
+using details::Check;
+using details::FieldCheck;
+
+[[nodiscard]] constexpr std::uint16_t bit(Value::Type type) noexcept {
+    return static_cast<std::uint16_t>(1U << static_cast<unsigned>(type));
+}
+
+constexpr std::uint16_t integer_types =
+    bit(Value::Type::UInt) | bit(Value::Type::Int);
+constexpr std::uint16_t number_types = integer_types | bit(Value::Type::Float);
+constexpr std::uint16_t any_type = number_types | bit(Value::Type::Bool) |
+                                   bit(Value::Type::String) |
+                                   bit(Value::Type::Array) |
+                                   bit(Value::Type::Object);
+
+[[nodiscard]] std::string format_number(Float number) {
+    std::array<char, 32> buffer{};
+    auto [end, error] =
+        std::to_chars(buffer.data(), buffer.data() + buffer.size(), number);
+
+    return {buffer.data(), end};
+}
+
+[[nodiscard]] std::string describe_types(std::uint16_t types) {
+    if ((types & any_type) == any_type) {
+        return "any value";
+    }
+
+    std::string result;
+
+    auto add = [&result](const char* name) {
+        result += result.empty() ? "" : " or ";
+        result += name;
+    };
+
+    if ((types & number_types) == number_types) {
+        add("a number");
+    } else if ((types & integer_types) == integer_types) {
+        add("an integer");
+    } else if ((types & bit(Value::Type::Float)) != 0) {
+        add("a float");
+    }
+
+    if ((types & bit(Value::Type::Bool)) != 0) {
+        add("a bool");
+    }
+
+    if ((types & bit(Value::Type::String)) != 0) {
+        add("a string");
+    }
+
+    if ((types & bit(Value::Type::Array)) != 0) {
+        add("an array");
+    }
+
+    if ((types & bit(Value::Type::Object)) != 0) {
+        add("an object");
+    }
+
+    return result;
+}
+
+[[nodiscard]] const char* describe_type(Value::Type type) noexcept {
+    switch (type) {
+    case Value::Type::UInt:
+    case Value::Type::Int:
+        return "an integer";
+    case Value::Type::Float:
+        return "a float";
+    case Value::Type::Bool:
+        return "a bool";
+    case Value::Type::String:
+        return "a string";
+    case Value::Type::Array:
+        return "an array";
+    case Value::Type::Object:
+        return "an object";
+    case Value::Type::Undefined:
+        break;
+    }
+
+    return "an undefined value";
+}
+
+// Compiles schema entries depth first into the check and field tables.
+class Compiler {
+public:
+    [[nodiscard]] Compiler(
+        std::vector<Check>& checks, std::vector<FieldCheck>& fields) noexcept
+    : m_checks{checks}, m_fields{fields} {}
+
+    [[nodiscard]] std::uint32_t
+    compile(const Value& entry, const std::string& path) {
+        auto index = static_cast<std::uint32_t>(m_checks.size());
+        m_checks.emplace_back();
+
+        Check check;
+
+        if (!entry.is<Object>()) {
+            check.types = get_types(entry, path);
+            m_checks[index] = check;
+
+            return index;
+        }
+
+        const Object* fields = nullptr;
+
+        for (const auto& [key, value] : entry.get_strict<Object>()) {
+            if (key == "type") {
+                check.types = get_types(value, path);
+            } else if (key == "required") {
+                // Read by compile_fields; only checked here.
+                static_cast<void>(is_required(entry, path));
+            } else if (key == "min") {
+                check.has_min = true;
+                check.min = get_bound(value, key, path);
+            } else if (key == "max") {
+                check.has_max = true;
+                check.max = get_bound(value, key, path);
+            } else if (key == "items") {
+                check.items = compile(value, path + "[]");
+            } else if (key == "fields") {
+                if (!value.is<Object>()) {
+                    fail(path, "'fields' must be an object");
+                }
+
+                fields = &value.get_strict<Object>();
+            } else if (key == "unknown_keys") {
+                check.reject_unknown_keys = get_unknown_keys(value, path);
+            } else {
+                fail(path, "unknown property '" + key + "'");
+            }
+        }
+
+        if (check.types == 0) {
+            check.types = check.items != Check::none ? bit(Value::Type::Array)
+                          : fields != nullptr ? bit(Value::Type::Object)
+                                              : any_type;
+        }
+
+        if (check.items != Check::none &&
+            (check.types & bit(Value::Type::Array)) == 0) {
+            fail(path, "'items' needs the type to allow an array");
+        }
+
+        if (fields != nullptr) {
+            if ((check.types & bit(Value::Type::Object)) == 0) {
+                fail(path, "'fields' needs the type to allow an object");
+            }
+
+            compile_fields(check, *fields, path);
+        }
+
+        m_checks[index] = check;
+
+        return index;
+    }
+
+    void compile_fields(
+        Check& check, const Object& fields, const std::string& path) {
+        std::vector<const Object::value_type*> sorted;
+        sorted.reserve(fields.size());
+
+        for (const auto& field : fields) {
+            sorted.push_back(&field);
+        }
+
+        std::ranges::sort(sorted, {}, [](const auto* field) {
+            return std::string_view{field->first};
+        });
+
+        auto begin = m_fields.size();
+        m_fields.resize(begin + sorted.size());
+
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            auto field_path = path.empty() ? sorted[i]->first
+                                           : path + "." + sorted[i]->first;
+
+            m_fields[begin + i].key = sorted[i]->first;
+            m_fields[begin + i].is_required =
+                is_required(sorted[i]->second, field_path);
+
+            // Compiling a field may add fields of its own after this range.
+            auto field_check = compile(sorted[i]->second, field_path);
+            m_fields[begin + i].check = field_check;
+        }
+
+        check.fields_begin = static_cast<std::uint32_t>(begin);
+        check.fields_end = static_cast<std::uint32_t>(begin + sorted.size());
+    }
+
+private:
+    [[noreturn]] static void
+    fail(const std::string& path, const std::string& description) {
+        throw SchemaError{
+            path.empty() ? description
+                         : "'" + path + "': " + description};
+    }
+
+    [[nodiscard]] static std::uint16_t
+    get_type(const Value& name, const std::string& path) {
+        if (!name.is<String>()) {
+            fail(path, "a type must be a string");
+        }
+
+        const auto& string = name.get_strict<String>();
+
+        if (string == "any") {
+            return any_type;
+        }
+
+        if (string == "integer") {
+            return integer_types;
+        }
+
+        if (string == "float") {
+            return bit(Value::Type::Float);
+        }
+
+        if (string == "number") {
+            return number_types;
+        }
+
+        if (string == "bool") {
+            return bit(Value::Type::Bool);
+        }
+
+        if (string == "string") {
+            return bit(Value::Type::String);
+        }
+
+        if (string == "array") {
+            return bit(Value::Type::Array);
+        }
+
+        if (string == "object") {
+            return bit(Value::Type::Object);
+        }
+
+        fail(path, "unknown type '" + string + "'");
+    }
+
+    [[nodiscard]] static std::uint16_t
+    get_types(const Value& types, const std::string& path) {
+        if (!types.is<Array>()) {
+            return get_type(types, path);
+        }
+
+        std::uint16_t result = 0;
+
+        for (const auto& type : types.get_strict<Array>()) {
+            result |= get_type(type, path);
+        }
+
+        if (result == 0) {
+            fail(path, "the list of types is empty");
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] static bool
+    is_required(const Value& entry, const std::string& path) {
+        if (!entry.is<Object>()) {
+            return false;
+        }
+
+        const auto& properties = entry.get_strict<Object>();
+        auto required = properties.find("required");
+
+        if (required == properties.end()) {
+            return false;
+        }
+
+        if (!required->second.is<Bool>()) {
+            fail(path, "'required' must be a bool");
+        }
+
+        return required->second.get_strict<Bool>();
+    }
+
+    [[nodiscard]] static Float get_bound(
+        const Value& bound, const std::string& key, const std::string& path) {
+        if (!bound.is<UInt>() && !bound.is<Int>() && !bound.is<Float>()) {
+            fail(path, "'" + key + "' must be a number");
+        }
+
+        return bound.get<Float>();
+    }
+
+    [[nodiscard]] static bool
+    get_unknown_keys(const Value& policy, const std::string& path) {
+        if (policy.is<String>()) {
+            const auto& string = policy.get_strict<String>();
+
+            if (string == "reject") {
+                return true;
+            }
+
+            if (string == "collect") {
+                return false;
+            }
+        }
+
+        fail(path, "'unknown_keys' must be \"collect\" or \"reject\"");
+    }
+
+    std::vector<Check>& m_checks;
+    std::vector<FieldCheck>& m_fields;
+};
+
+// Location of the value being checked. Only turned into a string for a
+// violation, so that valid documents cost no allocations.
+struct Path {
+    const Path* parent = nullptr;
+
+    std::string_view key;
+    std::size_t index = 0;
+    bool is_element = false;
+};
+
+[[nodiscard]] std::string to_string(const Path* path) {
+    std::vector<const Path*> segments;
+
+    for (; path != nullptr; path = path->parent) {
+        segments.push_back(path);
+    }
+
+    std::string result;
+
+    for (auto segment = segments.rbegin(); segment != segments.rend();
+         ++segment) {
+        if ((*segment)->is_element) {
+            result += '[';
+            result += std::to_string((*segment)->index);
+            result += ']';
+            continue;
+        }
+
+        if (!result.empty()) {
+            result += '.';
+        }
+
+        result += (*segment)->key;
+    }
+
+    return result;
+}
+
+template <typename Element>
+constexpr Value::Type packed_type = std::is_same_v<Element, UInt>
+                                        ? Value::Type::UInt
+                                    : std::is_same_v<Element, Int>
+                                        ? Value::Type::Int
+                                    : std::is_same_v<Element, Float>
+                                        ? Value::Type::Float
+                                        : Value::Type::Bool;
+
+// Walks a value and the compiled checks side by side. The recursion is as
+// deep as the schema, not as the value, since parts of the value that the
+// schema does not describe are not visited.
+class Run {
+public:
+    [[nodiscard]] Run(
+        std::span<const Check> checks, std::span<const FieldCheck> fields,
+        std::vector<Violation>* violations) noexcept
+    : m_checks{checks}, m_fields{fields}, m_violations{violations} {}
+
+    [[nodiscard]] bool is_valid() const noexcept { return m_is_valid; }
+
+    void check(std::uint32_t index, const Value& value, const Path* path) {
+        const auto& check = m_checks[index];
+        auto type = value.get_type();
+
+        if (!check_type(check, type, path)) {
+            return;
+        }
+
+        switch (type) {
+        case Value::Type::UInt:
+        case Value::Type::Int:
+        case Value::Type::Float:
+            check_range(check, value.get<Float>(), false, path);
+            break;
+        case Value::Type::String:
+            check_range(
+                check, static_cast<Float>(value.get_strict<String>().size()),
+                true, path);
+            break;
+        case Value::Type::Array:
+            if (value.is<PackedArray>()) {
+                check_packed(check, value.get_strict<PackedArray>(), path);
+            } else {
+                check_elements(check, value.get_strict<Array>(), path);
+            }
+
+            break;
+        case Value::Type::Object:
+            check_members(check, value.get_strict<Object>(), path);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void check(std::uint32_t index, ValueView value, const Path* path) {
+        const auto& check = m_checks[index];
+        auto type = value.get_type();
+
+        if (!check_type(check, type, path)) {
+            return;
+        }
+
+        switch (type) {
+        case Value::Type::UInt:
+        case Value::Type::Int:
+        case Value::Type::Float:
+            check_range(check, value.get<Float>(), false, path);
+            break;
+        case Value::Type::String:
+            check_range(
+                check,
+                static_cast<Float>(value.get<std::string_view>().size()),
+                true, path);
+            break;
+        case Value::Type::Array:
+            check_elements(check, value, path);
+            break;
+        case Value::Type::Object:
+            check_members(check, value, path);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void check_members(const Check& check, const Object& object,
+                       const Path* path) {
+        check_range(check, static_cast<Float>(object.size()), true, path);
+
+        std::size_t found = 0;
+
+        for (auto i = check.fields_begin; i < check.fields_end; ++i) {
+            if (is_done()) {
+                return;
+            }
+
+            const auto& field = m_fields[i];
+            Path member_path{path, field.key, 0, false};
+
+            auto member = object.find(field.key);
+
+            if (member == object.end() ||
+                member->second.get_type() == Value::Type::Undefined) {
+                if (field.is_required) {
+                    report_missing(&member_path);
+                }
+
+                continue;
+            }
+
+            ++found;
+            this->check(field.check, member->second, &member_path);
+        }
+
+        // Only looks for the unknown keys once it is known there are some.
+        if (!check.reject_unknown_keys || found == object.size()) {
+            return;
+        }
+
+        auto fields = m_fields.subspan(
+            check.fields_begin, check.fields_end - check.fields_begin);
+
+        for (const auto& [key, value] : object) {
+            if (is_done()) {
+                return;
+            }
+
+            auto field = std::ranges::lower_bound(
+                fields, std::string_view{key}, {},
+                [](const FieldCheck& field) {
+                    return std::string_view{field.key};
+                });
+
+            if (field == fields.end() || field->key != key) {
+                Path member_path{path, key, 0, false};
+                report_unknown_key(&member_path);
+            }
+        }
+    }
+
+private:
+    [[nodiscard]] bool is_done() const noexcept {
+        return !m_is_valid && m_violations == nullptr;
+    }
+
+    template <typename Describe>
+    void report(Violation::Kind kind, const Path* path, Describe describe) {
+        m_is_valid = false;
+
+        if (m_violations != nullptr) {
+            m_violations->push_back({kind, to_string(path), describe()});
+        }
+    }
+
+    void report_missing(const Path* path) {
+        report(Violation::Kind::Missing, path, [] {
+            return std::string{"required field is missing"};
+        });
+    }
+
+    void report_unknown_key(const Path* path) {
+        report(Violation::Kind::UnknownKey, path, [] {
+            return std::string{"key is not described by the schema"};
+        });
+    }
+
+    bool check_type(const Check& check, Value::Type type, const Path* path) {
+        if ((check.types & bit(type)) != 0) {
+            return true;
+        }
+
+        report(Violation::Kind::Type, path, [&] {
+            return "expected " + describe_types(check.types) + ", found " +
+                   describe_type(type);
+        });
+
+        return false;
+    }
+
+    // A size is the length of a string or the number of elements or members.
+    void check_range(
+        const Check& check, Float value, bool is_size, const Path* path) {
+        const char* what = is_size ? "size " : "";
+
+        if (check.has_min && value < check.min) {
+            report(Violation::Kind::Range, path, [&] {
+                return what + format_number(value) +
+                       " is less than the minimum of " +
+                       format_number(check.min);
+            });
+        } else if (check.has_max && value > check.max) {
+            report(Violation::Kind::Range, path, [&] {
+                return what + format_number(value) +
+                       " is greater than the maximum of " +
+                       format_number(check.max);
+            });
+        }
+    }
+
+    template <typename Elements>
+    void check_elements(
+        const Check& check, const Elements& elements, const Path* path) {
+        check_range(check, static_cast<Float>(elements.size()), true, path);
+
+        if (check.items == Check::none) {
+            return;
+        }
+
+        std::size_t index = 0;
+
+        for (const auto& element : elements) {
+            if (is_done()) {
+                return;
+            }
+
+            Path element_path{path, {}, index++, true};
+            this->check(check.items, element, &element_path);
+        }
+    }
+
+    // Elements of a packed array share one type, so they are checked in a
+    // tight loop without looking at each element's type.
+    void check_packed(
+        const Check& check, const PackedArray& array, const Path* path) {
+        check_range(check, static_cast<Float>(array.size()), true, path);
+
+        if (check.items == Check::none) {
+            return;
+        }
+
+        const auto& items = m_checks[check.items];
+
+        array.visit([&](auto elements) {
+            using Element = typename decltype(elements)::value_type;
+
+            bool is_allowed = (items.types & bit(packed_type<Element>)) != 0;
+            bool is_bounded =
+                !std::is_same_v<Element, Bool> &&
+                (items.has_min || items.has_max);
+
+            if (is_allowed && !is_bounded) {
+                return;
+            }
+
+            for (std::size_t i = 0; i < elements.size() && !is_done(); ++i) {
+                Path element_path{path, {}, i, true};
+
+                if (!check_type(items, packed_type<Element>, &element_path)) {
+                    continue;
+                }
+
+                check_range(
+                    items, static_cast<Float>(elements[i]), false,
+                    &element_path);
+            }
+        });
+    }
+
+    // Members of a flat object are sorted by key like the fields, so both
+    // are walked in a single merge.
+    void check_members(const Check& check, ValueView object, const Path* path) {
+        check_range(check, static_cast<Float>(object.size()), true, path);
+
+        auto member = object.begin();
+        auto end = object.end();
+
+        // Reports the members before the key, or all that are left without
+        // one.
+        auto skip_unknown_keys = [&](const std::string* key) {
+            for (; member != end && !is_done() &&
+                   (key == nullptr || (*member).key() < *key);
+                 ++member) {
+                if (check.reject_unknown_keys) {
+                    Path member_path{path, (*member).key(), 0, false};
+                    report_unknown_key(&member_path);
+                }
+            }
+        };
+
+        for (auto i = check.fields_begin; i < check.fields_end; ++i) {
+            const auto& field = m_fields[i];
+            Path member_path{path, field.key, 0, false};
+
+            skip_unknown_keys(&field.key);
+
+            if (is_done()) {
+                return;
+            }
+
+            if (member == end || (*member).key() != field.key ||
+                (*member).get_type() == Value::Type::Undefined) {
+                if (field.is_required) {
+                    report_missing(&member_path);
+                }
+            } else {
+                this->check(field.check, *member, &member_path);
+            }
+
+            if (member != end && (*member).key() == field.key) {
+                ++member;
+            }
+        }
+
+        skip_unknown_keys(nullptr);
+    }
+
+    std::span<const Check> m_checks;
+    std::span<const FieldCheck> m_fields;
+
+    std::vector<Violation>* m_violations = nullptr;
+    bool m_is_valid = true;
+};
+
+} // namespace
+
+Validator::Validator() {
+    Check root;
+    root.types = bit(Value::Type::Object);
+
+    m_checks.push_back(root);
+}
+
+Validator::Validator(const Object& schema, UnknownKeys unknown_keys) {
+    Check root;
+    root.types = bit(Value::Type::Object);
+    root.reject_unknown_keys = unknown_keys == UnknownKeys::Reject;
+
+    m_checks.push_back(root);
+    Compiler{m_checks, m_fields}.compile_fields(root, schema, {});
+    m_checks.front() = root;
+}
+
+bool Validator::validate(
+    const Value& value, std::vector<Violation>& violations) const {
+    Run run{m_checks, m_fields, &violations};
+    run.check(0, value, nullptr);
+
+    return run.is_valid();
+}
+
+bool Validator::validate(
+    const Object& object, std::vector<Violation>& violations) const {
+    Run run{m_checks, m_fields, &violations};
+    run.check_members(m_checks.front(), object, nullptr);
+
+    return run.is_valid();
+}
+
+bool Validator::validate(
+    ValueView value, std::vector<Violation>& violations) const {
+    Run run{m_checks, m_fields, &violations};
+    run.check(0, value, nullptr);
+
+    return run.is_valid();
+}
+
+bool Validator::is_valid(const Value& value) const {
+    Run run{m_checks, m_fields, nullptr};
+    run.check(0, value, nullptr);
+
+    return run.is_valid();
+}
+
+bool Validator::is_valid(const Object& object) const {
+    Run run{m_checks, m_fields, nullptr};
+    run.check_members(m_checks.front(), object, nullptr);
+
+    return run.is_valid();
+}
+
+bool Validator::is_valid(ValueView value) const {
+    Run run{m_checks, m_fields, nullptr};
+    run.check(0, value, nullptr);
+
+    return run.is_valid();
+}
+
+} // namespace lumen